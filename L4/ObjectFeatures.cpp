@@ -0,0 +1,151 @@
+#include "ObjectFeatures.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+uint32_t ObjectFeatures::packColor(const cv::Vec3b& color) {
+    return static_cast<uint32_t>(color[0]) | static_cast<uint32_t>(color[1]) << 8 |
+           static_cast<uint32_t>(color[2]) << 16;
+}
+
+cv::Vec3b ObjectFeatures::unpackColor(const uint32_t key) {
+    return {static_cast<uchar>(key & 0xFF), static_cast<uchar>(key >> 8 & 0xFF), static_cast<uchar>(key >> 16 & 0xFF)};
+}
+
+void ObjectFeatures::Accumulator::merge(const Accumulator& other) {
+    area += other.area;
+    sumR += other.sumR;
+    sumC += other.sumC;
+    sumRR += other.sumRR;
+    sumCC += other.sumCC;
+    sumRC += other.sumRC;
+    contour += other.contour;
+    first = std::min(first, other.first);
+    minR = std::min(minR, other.minR);
+    maxR = std::max(maxR, other.maxR);
+    minC = std::min(minC, other.minC);
+    maxC = std::max(maxC, other.maxC);
+}
+
+template<typename Pixel>
+void ObjectFeatures::scanRows(const cv::Mat& image, const Pixel& background, const int rowBegin, const int rowEnd,
+                              std::vector<std::pair<uint32_t, Accumulator>>& out) {
+    std::unordered_map<uint32_t, Accumulator> objects;
+    Accumulator* acc = nullptr;
+    Pixel accPixel = background;
+
+    for (int r = rowBegin; r < rowEnd; r++) {
+        const Pixel* above = r > 0 ? image.ptr<Pixel>(r - 1) : nullptr;
+        const Pixel* row = image.ptr<Pixel>(r);
+        const Pixel* below = r < image.rows - 1 ? image.ptr<Pixel>(r + 1) : nullptr;
+
+        for (int c = 0; c < image.cols; c++) {
+            const Pixel& pixel = row[c];
+            if (pixel == background) {
+                continue;
+            }
+            if (acc == nullptr || pixel != accPixel) {
+                acc = &objects[keyOf(pixel)];
+                accPixel = pixel;
+            }
+
+            acc->area++;
+            acc->sumR += r;
+            acc->sumC += c;
+            acc->sumRR += static_cast<int64_t>(r) * r;
+            acc->sumCC += static_cast<int64_t>(c) * c;
+            acc->sumRC += static_cast<int64_t>(r) * c;
+            acc->first = std::min(acc->first, static_cast<int64_t>(r) * image.cols + c);
+            acc->minR = std::min(acc->minR, r);
+            acc->maxR = std::max(acc->maxR, r);
+            acc->minC = std::min(acc->minC, c);
+            acc->maxC = std::max(acc->maxC, c);
+
+            bool isContour = above == nullptr || below == nullptr || c == 0 || c == image.cols - 1;
+            for (int k = -1; !isContour && k <= 1; k++) {
+                isContour = above[c + k] != pixel || below[c + k] != pixel;
+            }
+            if (!isContour) {
+                isContour = row[c - 1] != pixel || row[c + 1] != pixel;
+            }
+            if (isContour) {
+                acc->contour++;
+            }
+        }
+    }
+
+    out.assign(objects.begin(), objects.end());
+}
+
+ObjectFeatureTable ObjectFeatures::buildTable(std::vector<std::pair<uint32_t, Accumulator>>& objects) {
+    std::ranges::sort(objects, {}, [](const auto& object) { return object.second.first; });
+
+    ObjectFeatureTable table;
+    const size_t n = objects.size();
+    table.key.reserve(n);
+    table.area.reserve(n);
+    table.centerOfMass.reserve(n);
+    table.elongation.reserve(n);
+    table.perimeter.reserve(n);
+    table.thinnessRatio.reserve(n);
+    table.aspectRatio.reserve(n);
+    table.boundingBox.reserve(n);
+
+    for (const auto& [key, acc] : objects) {
+        const auto area = static_cast<int>(acc.area);
+        const auto cr = static_cast<int64_t>(acc.sumR / acc.area);
+        const auto cc = static_cast<int64_t>(acc.sumC / acc.area);
+
+        // Second-order moments about the truncated center, as calcAngleOfElongation computes them.
+        const int64_t mrr = acc.sumRR - 2 * cr * acc.sumR + cr * cr * acc.area;
+        const int64_t mcc = acc.sumCC - 2 * cc * acc.sumC + cc * cc * acc.area;
+        const int64_t mrc = acc.sumRC - cc * acc.sumR - cr * acc.sumC + cr * cc * acc.area;
+
+        const int perimeter = static_cast<int>(static_cast<double>(acc.contour) * M_PI / 4.0);
+        const int width = acc.maxC - acc.minC + 1;
+        const int height = acc.maxR - acc.minR + 1;
+
+        table.key.push_back(key);
+        table.area.push_back(area);
+        table.centerOfMass.emplace_back(static_cast<int>(cr), static_cast<int>(cc));
+        table.elongation.push_back(atan2(2.0 * static_cast<double>(mrc), static_cast<double>(mcc - mrr)) / 2);
+        table.perimeter.push_back(perimeter);
+        table.thinnessRatio.push_back(perimeter > 0
+            ? static_cast<float>(M_PI * 4 * area / (static_cast<double>(perimeter) * perimeter))
+            : 0.0f);
+        table.aspectRatio.push_back(static_cast<float>(width) / static_cast<float>(height));
+        table.boundingBox.emplace_back(acc.minC, acc.minR, width, height);
+    }
+
+    return table;
+}
+
+ObjectFeatureTable ObjectFeatures::computeAll(const cv::Mat& image) {
+    CV_Assert(image.type() == CV_8UC3 || image.type() == CV_32SC1);
+
+    const int stripes = std::max(1, std::min(image.rows, cv::getNumThreads() * 4));
+    std::vector<std::vector<std::pair<uint32_t, Accumulator>>> partial(stripes);
+
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; s++) {
+            const int rowBegin = image.rows * s / stripes;
+            const int rowEnd = image.rows * (s + 1) / stripes;
+            if (image.type() == CV_8UC3) {
+                scanRows<cv::Vec3b>(image, cv::Vec3b(255, 255, 255), rowBegin, rowEnd, partial[s]);
+            } else {
+                scanRows<int>(image, 0, rowBegin, rowEnd, partial[s]);
+            }
+        }
+    });
+
+    std::unordered_map<uint32_t, Accumulator> merged;
+    for (const auto& stripe : partial) {
+        for (const auto& [key, acc] : stripe) {
+            merged[key].merge(acc);
+        }
+    }
+
+    std::vector<std::pair<uint32_t, Accumulator>> objects(merged.begin(), merged.end());
+    return buildTable(objects);
+}
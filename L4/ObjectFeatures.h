@@ -0,0 +1,53 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// One row per object, stored column-wise. Centers of mass follow the
+// (row, col) convention of calcCenterOfMass in main.cpp.
+struct ObjectFeatureTable {
+    std::vector<uint32_t> key;
+    std::vector<int> area;
+    std::vector<cv::Point2i> centerOfMass;
+    std::vector<double> elongation;
+    std::vector<int> perimeter;
+    std::vector<float> thinnessRatio;
+    std::vector<float> aspectRatio;
+    std::vector<cv::Rect> boundingBox;
+
+    [[nodiscard]] size_t size() const { return key.size(); }
+};
+
+class ObjectFeatures {
+public:
+    // CV_8UC3 images are keyed by colour (white is background), CV_32S label
+    // images by label (0 is background). Objects are ordered by their first
+    // pixel in raster order.
+    static ObjectFeatureTable computeAll(const cv::Mat& image);
+
+    static uint32_t packColor(const cv::Vec3b& color);
+    static cv::Vec3b unpackColor(uint32_t key);
+
+    // Object key of a pixel: its packed colour, or the label itself.
+    static uint32_t keyOf(const cv::Vec3b& pixel) { return packColor(pixel); }
+    static uint32_t keyOf(const int pixel) { return static_cast<uint32_t>(pixel); }
+
+private:
+    struct Accumulator {
+        int64_t area = 0;
+        int64_t sumR = 0, sumC = 0;
+        int64_t sumRR = 0, sumCC = 0, sumRC = 0;
+        int64_t contour = 0;
+        int64_t first = INT64_MAX;
+        int minR = INT32_MAX, maxR = -1;
+        int minC = INT32_MAX, maxC = -1;
+
+        void merge(const Accumulator& other);
+    };
+
+    template<typename Pixel>
+    static void scanRows(const cv::Mat& image, const Pixel& background, int rowBegin, int rowEnd,
+                         std::vector<std::pair<uint32_t, Accumulator>>& out);
+    static ObjectFeatureTable buildTable(std::vector<std::pair<uint32_t, Accumulator>>& objects);
+};
@@ -0,0 +1,59 @@
+#include "ObjectIndex.h"
+#include "ObjectFeatures.h"
+
+#include <algorithm>
+
+ObjectIndex::ObjectIndex(const cv::Mat& image) {
+    CV_Assert(image.type() == CV_8UC3 || image.type() == CV_32SC1);
+
+    if (image.type() == CV_8UC3) {
+        build<cv::Vec3b>(image);
+    } else {
+        build<int>(image);
+    }
+}
+
+template<typename Pixel>
+void ObjectIndex::build(const cv::Mat& image) {
+    std::unordered_map<uint32_t, cv::Point2i> maxCorner;
+
+    for (int r = 0; r < image.rows; r++) {
+        const Pixel* row = image.ptr<Pixel>(r);
+        int c = 0;
+        while (c < image.cols) {
+            const Pixel& pixel = row[c];
+            const int begin = c;
+            while (c < image.cols && row[c] == pixel) {
+                c++;
+            }
+
+            const uint32_t key = ObjectFeatures::keyOf(pixel);
+            auto& object = objects[key];
+            auto& corner = maxCorner[key];
+            if (object.runs.empty()) {
+                object.boundingBox = cv::Rect(begin, r, 0, 0);
+            }
+            object.runs.push_back({r, begin, c});
+            object.area += c - begin;
+
+            object.boundingBox.x = std::min(object.boundingBox.x, begin);
+            corner.x = std::max(corner.x, c - 1);
+            corner.y = r;
+        }
+    }
+
+    for (auto& [key, object] : objects) {
+        const auto& corner = maxCorner[key];
+        object.boundingBox.width = corner.x - object.boundingBox.x + 1;
+        object.boundingBox.height = corner.y - object.boundingBox.y + 1;
+    }
+}
+
+const ObjectRuns* ObjectIndex::find(const cv::Vec3b& color) const {
+    return find(ObjectFeatures::packColor(color));
+}
+
+const ObjectRuns* ObjectIndex::find(const uint32_t key) const {
+    const auto it = objects.find(key);
+    return it == objects.end() ? nullptr : &it->second;
+}
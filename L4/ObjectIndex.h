@@ -0,0 +1,36 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+struct PixelRun {
+    int row;
+    int begin;
+    int end;
+};
+
+struct ObjectRuns {
+    std::vector<PixelRun> runs;
+    cv::Rect boundingBox;
+    int area = 0;
+};
+
+// Run-length index of every object in an image, built in one raster scan.
+// Keys match ObjectFeatures: packed colour for CV_8UC3 images, label for
+// CV_32S label images.
+class ObjectIndex {
+public:
+    explicit ObjectIndex(const cv::Mat& image);
+
+    [[nodiscard]] const ObjectRuns* find(const cv::Vec3b& color) const;
+    [[nodiscard]] const ObjectRuns* find(uint32_t key) const;
+    [[nodiscard]] size_t size() const { return objects.size(); }
+
+private:
+    std::unordered_map<uint32_t, ObjectRuns> objects;
+
+    template<typename Pixel>
+    void build(const cv::Mat& image);
+};
@@ -2,18 +2,26 @@
 #include <cmath>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
+#include "ObjectFeatures.h"
+#include "ObjectIndex.h"
 
 using namespace cv;
 
+struct ImageContext {
+    Mat image;
+    ObjectIndex index;
+};
+
 void onMouse(int event, int x, int y, int flags, void *userdata);
-int calcArea(Mat &img, const Vec3b &color);
-Point2i calcCenterOfMass(Mat &img, int area, const Vec3b &color);
-double calcAngleOfElongation(Mat &img, const Point2i &centerOfMass, const Vec3b &color);
-std::pair<int, int> findMinMaxColumns(Mat &img, const Vec3b &color);
-int calcPerimeter(Mat &img, const Vec3b &color);
+int calcArea(const ObjectRuns &object);
+Point2i calcCenterOfMass(const ObjectRuns &object, int area);
+double calcAngleOfElongation(const ObjectRuns &object, const Point2i &centerOfMass);
+std::pair<int, int> findMinMaxColumns(const ObjectRuns &object);
+int calcPerimeter(const Mat &img, const ObjectRuns &object, const Vec3b &color);
 float calcThinnessRatio(int perimeter, int area);
-float calcAspectRatio(Mat &img, const Vec3b &color);
-void showProjections(Mat &img, const Vec3b &color);
+float calcAspectRatio(const ObjectRuns &object);
+void showProjections(const Mat &img, const ObjectRuns &object);
+void printFeatureTable(const ObjectFeatureTable &table);
 
 int main(int argc, char **argv) {
     Mat image = imread("../images/trasaturi_geom.bmp", IMREAD_COLOR);
@@ -21,25 +29,30 @@ int main(int argc, char **argv) {
         std::cout << "Could not open or find the image" << std::endl;
         return -1;
     }
+    printFeatureTable(ObjectFeatures::computeAll(image));
+
     namedWindow("Image", WINDOW_AUTOSIZE);
 
-    setMouseCallback("Image", onMouse, &image);
+    ImageContext context{image, ObjectIndex(image)};
+    setMouseCallback("Image", onMouse, &context);
     imshow("Image", image);
     while ((waitKey(0) & 0xFF) != 27){}
     return 0;
 }
 
 void onMouse(int event, int x, int y, int flags, void *userdata) {
-    const auto image = static_cast<Mat *>(userdata);
+    const auto context = static_cast<ImageContext *>(userdata);
+    const Mat *image = &context->image;
     if (event == EVENT_LBUTTONDOWN) {
         if (x >= 0 && y >= 0 && x < image->cols && y < image->rows) {
             const Vec3b &color = image->at<Vec3b>(y, x);
-            const auto objArea = calcArea(*image, color);
-            const auto centerOfMass = calcCenterOfMass(*image, objArea, color);
-            const auto phi = calcAngleOfElongation(*image, centerOfMass, color);
-            const auto perimeter = calcPerimeter(*image, color);
+            const ObjectRuns &object = *context->index.find(color);
+            const auto objArea = calcArea(object);
+            const auto centerOfMass = calcCenterOfMass(object, objArea);
+            const auto phi = calcAngleOfElongation(object, centerOfMass);
+            const auto perimeter = calcPerimeter(*image, object, color);
             const auto thinnessRatio = calcThinnessRatio(perimeter, objArea);
-            const auto aspectRatio = calcAspectRatio(*image, color);
+            const auto aspectRatio = calcAspectRatio(object);
 
             std::cout << "Area: " << objArea << "\n"
                   << "Center of mass: (" << centerOfMass.x << ", " << centerOfMass.y << ")\n"
@@ -50,99 +63,92 @@ void onMouse(int event, int x, int y, int flags, void *userdata) {
 
             Mat displayImage = image->clone();
             circle(displayImage, Point(centerOfMass.y, centerOfMass.x), 5, Scalar(0, 0, 255), -1);
-            const auto [minCol, maxCol] = findMinMaxColumns(*image, color);
+            const auto [minCol, maxCol] = findMinMaxColumns(object);
             const int r1 = static_cast<int>(centerOfMass.x + tan(phi) * (maxCol - centerOfMass.y));
             const int r2 = static_cast<int>(centerOfMass.x - tan(phi) * (centerOfMass.y - minCol));
             line(displayImage, Point(minCol, r2), Point(maxCol, r1), Scalar(0, 255, 0), 2);
             imshow("Image", displayImage);
 
-            showProjections(*image, color);
+            showProjections(*image, object);
         }
     }
 }
 
-int calcArea(Mat &img, const Vec3b &color) {
+void printFeatureTable(const ObjectFeatureTable &table) {
+    std::cout << "Objects: " << table.size() << "\n";
+    for (size_t i = 0; i < table.size(); i++) {
+        const Vec3b color = ObjectFeatures::unpackColor(table.key[i]);
+        const Rect &bbox = table.boundingBox[i];
+        std::cout << "Color (" << static_cast<int>(color[0]) << ", " << static_cast<int>(color[1]) << ", "
+                  << static_cast<int>(color[2]) << ")"
+                  << " area: " << table.area[i]
+                  << " center: (" << table.centerOfMass[i].x << ", " << table.centerOfMass[i].y << ")"
+                  << " angle: " << static_cast<int>((table.elongation[i] + M_PI) * 180 / M_PI)
+                  << " perimeter: " << table.perimeter[i]
+                  << " thinness: " << table.thinnessRatio[i]
+                  << " aspect: " << table.aspectRatio[i]
+                  << " bbox: " << bbox.x << " " << bbox.y << " " << bbox.width << "x" << bbox.height << "\n";
+    }
+}
+
+int calcArea(const ObjectRuns &object) {
     int area = 0;
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            if (img.at<Vec3b>(i, j) == color) {
-                area++;
-            }
-        }
+    for (const auto &run : object.runs) {
+        area += run.end - run.begin;
     }
     return area;
 }
 
-Point2i calcCenterOfMass(Mat &img, const int area, const Vec3b &color) {
-    int xSum = 0;
-    int ySum = 0;
-    for (int r = 0; r < img.rows; r++) {
-        for (int c = 0; c < img.cols; c++) {
-            if (img.at<Vec3b>(r, c) == color) {
-                ySum += c;
-                xSum += r;
-            }
-        }
+Point2i calcCenterOfMass(const ObjectRuns &object, const int area) {
+    long long xSum = 0;
+    long long ySum = 0;
+    for (const auto &run : object.runs) {
+        const int length = run.end - run.begin;
+        xSum += static_cast<long long>(run.row) * length;
+        ySum += static_cast<long long>(run.begin + run.end - 1) * length / 2;
     }
-    return {xSum / area, ySum / area};
+    return {static_cast<int>(xSum / area), static_cast<int>(ySum / area)};
 }
 
-double calcAngleOfElongation(Mat &img, const Point2i &centerOfMass, const Vec3b &color) {
-    int mrc = 0;
-    int mcc = 0;
-    int mrr = 0;
-
-    for (int r = 0; r < img.rows; r++) {
-        for (int c = 0; c < img.cols; c++) {
-            if (img.at<Vec3b>(r, c) == color) {
-                mrr += (r - centerOfMass.x) * (r - centerOfMass.x);
-                mcc += (c - centerOfMass.y) * (c - centerOfMass.y);
-                mrc += (r - centerOfMass.x) * (c - centerOfMass.y);
-            }
+double calcAngleOfElongation(const ObjectRuns &object, const Point2i &centerOfMass) {
+    long long mrc = 0;
+    long long mcc = 0;
+    long long mrr = 0;
+
+    for (const auto &run : object.runs) {
+        const int r = run.row;
+        for (int c = run.begin; c < run.end; c++) {
+            mrr += (r - centerOfMass.x) * (r - centerOfMass.x);
+            mcc += (c - centerOfMass.y) * (c - centerOfMass.y);
+            mrc += (r - centerOfMass.x) * (c - centerOfMass.y);
         }
     }
 
-    const double phi = atan2(2 * mrc, mcc - mrr) / 2;
+    const double phi = atan2(2.0 * mrc, static_cast<double>(mcc - mrr)) / 2;
     return phi;
 }
 
-std::pair<int, int> findMinMaxColumns(Mat &img, const Vec3b &color) {
-    int minCol = img.cols - 1;
-    int maxCol = 0;
-    for (int r = 0; r < img.rows; r++) {
-        for (int c = 0; c < img.cols; c++) {
-            if (img.at<Vec3b>(r, c) == color) {
-                minCol = std::min(minCol, c);
-                maxCol = std::max(maxCol, c);
-            }
-        }
-    }
-    return {minCol, maxCol};
+std::pair<int, int> findMinMaxColumns(const ObjectRuns &object) {
+    return {object.boundingBox.x, object.boundingBox.x + object.boundingBox.width - 1};
 }
 
-int calcPerimeter(Mat &img, const Vec3b &color) {
+int calcPerimeter(const Mat &img, const ObjectRuns &object, const Vec3b &color) {
     int perimeter = 0;
     constexpr int dr[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
     constexpr int dc[8] = {0, 1, 1, 1, 0, -1, -1, -1};
-    bool isContour = false;
-
-    for (int r = 0; r < img.rows; r++) {
-        for (int c = 0; c < img.cols; c++) {
-            isContour = false;
-            if (img.at<Vec3b>(r, c) == color) {
-                for (int k = 0; k < 8; k++) {
-                    const int newR = r + dr[k];
-                    const int newC = c + dc[k];
-
-                    if (newR >= 0 && newR < img.rows && newC >= 0 && newC < img.cols) {
-                        if (img.at<Vec3b>(newR, newC) != color) {
-                            isContour = true;
-                            break;
-                        }
-                    } else {
-                        isContour = true;
-                        break;
-                    }
+
+    for (const auto &run : object.runs) {
+        const int r = run.row;
+        for (int c = run.begin; c < run.end; c++) {
+            bool isContour = false;
+            for (int k = 0; k < 8; k++) {
+                const int newR = r + dr[k];
+                const int newC = c + dc[k];
+
+                if (newR < 0 || newR >= img.rows || newC < 0 || newC >= img.cols ||
+                    img.at<Vec3b>(newR, newC) != color) {
+                    isContour = true;
+                    break;
                 }
             }
             if (isContour) {
@@ -158,38 +164,24 @@ float calcThinnessRatio(const int perimeter, const int area) {
     return M_PI * 4 * static_cast<float>(area) / static_cast<float>(perimeter * perimeter);
 }
 
-float calcAspectRatio(Mat &img, const Vec3b &color) {
-    int maxCol = 0, maxRow = 0;
-    int minCol = img.cols - 1;
-    int minRow = img.rows - 1;
-
-    for (int r = 0; r < img.rows; r++) {
-        for (int c = 0; c < img.cols; c++) {
-            if (img.at<Vec3b>(r, c) == color) {
-                minRow = std::min(minRow, r);
-                maxRow = std::max(maxRow, r);
-                minCol = std::min(minCol, c);
-                maxCol = std::max(maxCol, c);
-            }
-        }
-    }
-
-    const auto width = static_cast<float>(maxCol - minCol + 1);
-    const auto height = static_cast<float>(maxRow - minRow + 1);
+float calcAspectRatio(const ObjectRuns &object) {
+    const auto width = static_cast<float>(object.boundingBox.width);
+    const auto height = static_cast<float>(object.boundingBox.height);
 
     return width / height;
 }
 
-void showProjections(Mat &img, const Vec3b &color) {
-    std::vector horizontalProj(img.rows, 0);
-    std::vector verticalProj(img.cols, 0);
-
-    for (int r = 0; r < img.rows; r++) {
-        for (int c = 0; c < img.cols; c++) {
-            if (img.at<Vec3b>(r, c) == color) {
-                horizontalProj[r]++;
-                verticalProj[c]++;
-            }
+void showProjections(const Mat &img, const ObjectRuns &object) {
+    // Projections cover the object's bounding box only; index i holds row
+    // or column box.y + i or box.x + i.
+    const Rect &box = object.boundingBox;
+    std::vector horizontalProj(box.height, 0);
+    std::vector verticalProj(box.width, 0);
+
+    for (const auto &run : object.runs) {
+        horizontalProj[run.row - box.y] += run.end - run.begin;
+        for (int c = run.begin; c < run.end; c++) {
+            verticalProj[c - box.x]++;
         }
     }
 
@@ -203,9 +195,9 @@ void showProjections(Mat &img, const Vec3b &color) {
 
     Mat vertProjImg(height, width, CV_8UC3, Scalar(255, 255, 255));
 
-    for (int r = 0; r < img.rows; r++) {
-        const int scaledRow = r * height / img.rows;
-        const int projLength = horizontalProj[r] * width / maxHorz;
+    for (int i = 0; i < box.height; i++) {
+        const int scaledRow = (box.y + i) * height / img.rows;
+        const int projLength = horizontalProj[i] * width / maxHorz;
 
         line(horzProjImg,
              Point(0, scaledRow),
@@ -213,9 +205,9 @@ void showProjections(Mat &img, const Vec3b &color) {
              Scalar(0, 0, 255), 2);
     }
 
-    for (int c = 0; c < img.cols; c++) {
-        const int scaledCol = c * width / img.cols;
-        const int projLength = verticalProj[c] * height / maxVert;
+    for (int i = 0; i < box.width; i++) {
+        const int scaledCol = (box.x + i) * width / img.cols;
+        const int projLength = verticalProj[i] * height / maxVert;
 
         line(vertProjImg,
              Point(scaledCol, height - 1),
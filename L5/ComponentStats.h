@@ -0,0 +1,95 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <vector>
+
+// Raw moment sums of one component, accumulated pixel by pixel or run by
+// run while labeling.
+struct ComponentMoments {
+    int64_t area = 0;
+    int64_t sumX = 0, sumY = 0;
+    int64_t sumXX = 0, sumYY = 0, sumXY = 0;
+    int minX = INT_MAX, minY = INT_MAX;
+    int maxX = -1, maxY = -1;
+
+    void addPixel(const int x, const int y) {
+        area++;
+        sumX += x;
+        sumY += y;
+        sumXX += static_cast<int64_t>(x) * x;
+        sumYY += static_cast<int64_t>(y) * y;
+        sumXY += static_cast<int64_t>(x) * y;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    // Pixels begin .. end - 1 of row y.
+    void addRun(const int y, const int begin, const int end) {
+        const int64_t n = end - begin;
+        const int64_t sx = (static_cast<int64_t>(begin) + end - 1) * n / 2;
+        const auto squares = [](const int64_t k) { return (k - 1) * k * (2 * k - 1) / 6; };
+        area += n;
+        sumX += sx;
+        sumY += n * y;
+        sumXX += squares(end) - squares(begin);
+        sumYY += n * y * y;
+        sumXY += sx * y;
+        minX = std::min(minX, begin);
+        maxX = std::max(maxX, end - 1);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+
+    void merge(const ComponentMoments& other) {
+        area += other.area;
+        sumX += other.sumX;
+        sumY += other.sumY;
+        sumXX += other.sumXX;
+        sumYY += other.sumYY;
+        sumXY += other.sumXY;
+        minX = std::min(minX, other.minX);
+        maxX = std::max(maxX, other.maxX);
+        minY = std::min(minY, other.minY);
+        maxY = std::max(maxY, other.maxY);
+    }
+};
+
+// Per-component statistics as parallel arrays; entry i belongs to label i + 1.
+// mu20, mu02 and mu11 are the central second-order moments.
+struct ComponentStats {
+    std::vector<int> area;
+    std::vector<cv::Rect> boundingBox;
+    std::vector<cv::Point2d> centroid;
+    std::vector<double> mu20, mu02, mu11;
+
+    [[nodiscard]] int size() const { return static_cast<int>(area.size()); }
+
+    void assign(const std::vector<ComponentMoments>& moments) {
+        const size_t n = moments.size();
+        area.resize(n);
+        boundingBox.resize(n);
+        centroid.resize(n);
+        mu20.resize(n);
+        mu02.resize(n);
+        mu11.resize(n);
+
+        for (size_t i = 0; i < n; i++) {
+            const ComponentMoments& m = moments[i];
+            const auto a = static_cast<double>(m.area);
+            const double cx = static_cast<double>(m.sumX) / a;
+            const double cy = static_cast<double>(m.sumY) / a;
+
+            area[i] = static_cast<int>(m.area);
+            boundingBox[i] = cv::Rect(m.minX, m.minY, m.maxX - m.minX + 1, m.maxY - m.minY + 1);
+            centroid[i] = cv::Point2d(cx, cy);
+            mu20[i] = static_cast<double>(m.sumXX) - cx * static_cast<double>(m.sumX);
+            mu02[i] = static_cast<double>(m.sumYY) - cy * static_cast<double>(m.sumY);
+            mu11[i] = static_cast<double>(m.sumXY) - cx * static_cast<double>(m.sumY);
+        }
+    }
+};
@@ -0,0 +1,290 @@
+#include "Labeling.h"
+#include "UnionFind.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+template<Connectivity C>
+int Labeling::scanRows(const cv::Mat& img, cv::Mat& labels, UnionFind& equivalences,
+                       const int rowBegin, const int rowEnd, const int firstLabel,
+                       std::vector<ComponentMoments>* moments) {
+    int next = firstLabel;
+    const int cols = img.cols;
+
+    const auto newLabel = [&] {
+        equivalences.makeSet(next);
+        if (moments != nullptr) {
+            moments->resize(next - firstLabel + 1);
+        }
+        return next++;
+    };
+
+    for (int r = rowBegin; r < rowEnd; r++) {
+        const uchar* row = img.ptr<uchar>(r);
+        const uchar* rowAbove = r > rowBegin ? img.ptr<uchar>(r - 1) : nullptr;
+        int* lab = labels.ptr<int>(r);
+        const int* labAbove = r > rowBegin ? labels.ptr<int>(r - 1) : nullptr;
+
+        for (int c = 0; c < cols; c++) {
+            if (row[c] != 0) {
+                lab[c] = 0;
+                continue;
+            }
+
+            int l;
+            if constexpr (C == Connectivity::Four) {
+                const bool b = rowAbove && rowAbove[c] == 0;
+                const bool d = c > 0 && row[c - 1] == 0;
+
+                if (b && d) {
+                    l = equivalences.merge(labAbove[c], lab[c - 1]);
+                } else if (b) {
+                    l = labAbove[c];
+                } else if (d) {
+                    l = lab[c - 1];
+                } else {
+                    l = newLabel();
+                }
+            } else {
+                // a b c
+                // d x
+                const bool a = rowAbove && c > 0 && rowAbove[c - 1] == 0;
+                const bool b = rowAbove && rowAbove[c] == 0;
+                const bool cc = rowAbove && c + 1 < cols && rowAbove[c + 1] == 0;
+                const bool d = c > 0 && row[c - 1] == 0;
+
+                if (b) {
+                    l = labAbove[c];
+                } else if (cc) {
+                    if (a) {
+                        l = equivalences.merge(labAbove[c + 1], labAbove[c - 1]);
+                    } else if (d) {
+                        l = equivalences.merge(labAbove[c + 1], lab[c - 1]);
+                    } else {
+                        l = labAbove[c + 1];
+                    }
+                } else if (a) {
+                    l = labAbove[c - 1];
+                } else if (d) {
+                    l = lab[c - 1];
+                } else {
+                    l = newLabel();
+                }
+            }
+
+            lab[c] = l;
+            if (moments != nullptr) {
+                (*moments)[l - firstLabel].addPixel(c, r);
+            }
+        }
+    }
+
+    return next;
+}
+
+template<Connectivity C>
+void Labeling::mergeSeam(const cv::Mat& img, const cv::Mat& labels, UnionFind& equivalences, const int row) {
+    const uchar* below = img.ptr<uchar>(row);
+    const uchar* above = img.ptr<uchar>(row - 1);
+    const int* labBelow = labels.ptr<int>(row);
+    const int* labAbove = labels.ptr<int>(row - 1);
+
+    for (int c = 0; c < img.cols; c++) {
+        if (below[c] != 0) {
+            continue;
+        }
+        if (above[c] == 0) {
+            equivalences.mergeConcurrent(labBelow[c], labAbove[c]);
+        } else if constexpr (C == Connectivity::Eight) {
+            if (c > 0 && above[c - 1] == 0) {
+                equivalences.mergeConcurrent(labBelow[c], labAbove[c - 1]);
+            }
+            if (c + 1 < img.cols && above[c + 1] == 0) {
+                equivalences.mergeConcurrent(labBelow[c], labAbove[c + 1]);
+            }
+        }
+    }
+}
+
+void Labeling::relabelRows(cv::Mat& labels, const UnionFind& equivalences, const int rowBegin, const int rowEnd) {
+    for (int r = rowBegin; r < rowEnd; r++) {
+        int* lab = labels.ptr<int>(r);
+        for (int c = 0; c < labels.cols; c++) {
+            lab[c] = equivalences[lab[c]];
+        }
+    }
+}
+
+void Labeling::collectStats(const std::vector<ComponentMoments>& moments, const UnionFind& equivalences,
+                            const int begin, const int end, std::vector<ComponentMoments>& components) {
+    for (int i = begin; i < end; i++) {
+        components[equivalences[i] - 1].merge(moments[i - begin]);
+    }
+}
+
+int Labeling::unionFind(const cv::Mat& img, cv::Mat& labels, cv::Mat* firstPass, ComponentStats* stats) {
+    CV_Assert(img.type() == CV_8UC1);
+
+    labels.create(img.size(), CV_32S);
+    UnionFind equivalences(img.cols + 1);
+    std::vector<ComponentMoments> moments;
+
+    const int provisional = scanRows<Connectivity::Eight>(img, labels, equivalences, 0, img.rows, 1,
+                                                          stats != nullptr ? &moments : nullptr);
+    if (firstPass != nullptr) {
+        *firstPass = labels.clone();
+    }
+
+    const int count = equivalences.flatten(1, provisional, 1) - 1;
+    relabelRows(labels, equivalences, 0, img.rows);
+
+    if (stats != nullptr) {
+        std::vector<ComponentMoments> components(count);
+        collectStats(moments, equivalences, 1, provisional, components);
+        stats->assign(components);
+    }
+    return count;
+}
+
+template<Connectivity C>
+int Labeling::labelStripes(const cv::Mat& img, cv::Mat& labels, ComponentStats* stats) {
+    labels.create(img.size(), CV_32S);
+
+    const int stripes = std::max(1, std::min(img.rows, cv::getNumThreads() * 2));
+    std::vector<int> rowBegin(stripes + 1);
+    std::vector<int> firstLabel(stripes + 1);
+    firstLabel[0] = 1;
+    for (int s = 0; s <= stripes; s++) {
+        rowBegin[s] = static_cast<int>(static_cast<int64_t>(img.rows) * s / stripes);
+        if (s > 0) {
+            // Upper bound on the provisional labels a stripe can create.
+            const int64_t height = rowBegin[s] - rowBegin[s - 1];
+            const int64_t bound = C == Connectivity::Eight
+                ? (height + 1) / 2 * ((img.cols + 1) / 2)
+                : (height * img.cols + 1) / 2;
+            CV_Assert(firstLabel[s - 1] + bound < INT32_MAX);
+            firstLabel[s] = static_cast<int>(firstLabel[s - 1] + bound);
+        }
+    }
+
+    UnionFind equivalences(firstLabel[stripes]);
+    std::vector<int> nextLabel(stripes);
+    // Moments grow with the labels each stripe actually creates; sizing
+    // them by the bounds above would cost tens of bytes per pixel.
+    std::vector<std::vector<ComponentMoments>> moments(stats != nullptr ? stripes : 0);
+
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; s++) {
+            nextLabel[s] = scanRows<C>(img, labels, equivalences, rowBegin[s], rowBegin[s + 1], firstLabel[s],
+                                       stats != nullptr ? &moments[s] : nullptr);
+        }
+    });
+
+    cv::parallel_for_(cv::Range(1, stripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; s++) {
+            mergeSeam<C>(img, labels, equivalences, rowBegin[s]);
+        }
+    });
+
+    int count = 1;
+    for (int s = 0; s < stripes; s++) {
+        count = equivalences.flatten(firstLabel[s], nextLabel[s], count);
+    }
+
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; s++) {
+            relabelRows(labels, equivalences, rowBegin[s], rowBegin[s + 1]);
+        }
+    });
+
+    if (stats != nullptr) {
+        std::vector<ComponentMoments> components(count - 1);
+        for (int s = 0; s < stripes; s++) {
+            collectStats(moments[s], equivalences, firstLabel[s], nextLabel[s], components);
+        }
+        stats->assign(components);
+    }
+    return count - 1;
+}
+
+int Labeling::parallelUnionFind(const cv::Mat& img, cv::Mat& labels, const Connectivity connectivity,
+                                ComponentStats* stats) {
+    CV_Assert(img.type() == CV_8UC1);
+
+    if (connectivity == Connectivity::Four) {
+        return labelStripes<Connectivity::Four>(img, labels, stats);
+    }
+    return labelStripes<Connectivity::Eight>(img, labels, stats);
+}
+
+template<Connectivity C>
+int Labeling::floodFill(const cv::Mat& img, cv::Mat& labels, ComponentStats* stats) {
+    CV_Assert(img.type() == CV_8UC1);
+
+    labels = cv::Mat::zeros(img.size(), CV_32S);
+    const int cols = img.cols;
+    constexpr int reach = C == Connectivity::Eight ? 1 : 0;
+
+    std::vector<Span> stack;
+    stack.reserve(img.rows * 2);
+    std::vector<ComponentMoments> moments;
+    int label = 0;
+
+    const auto fillRow = [&](const int r, const int from, const int to) {
+        const uchar* row = img.ptr<uchar>(r);
+        int* lab = labels.ptr<int>(r);
+        for (int c = std::max(0, from); c < std::min(cols, to); c++) {
+            if (row[c] != 0 || lab[c] != 0) {
+                continue;
+            }
+            int begin = c;
+            while (begin > 0 && row[begin - 1] == 0 && lab[begin - 1] == 0) {
+                begin--;
+            }
+            int end = c + 1;
+            while (end < cols && row[end] == 0 && lab[end] == 0) {
+                end++;
+            }
+            std::fill(lab + begin, lab + end, label);
+            stack.push_back({r, begin, end});
+            if (stats != nullptr) {
+                moments.back().addRun(r, begin, end);
+            }
+            c = end;
+        }
+    };
+
+    for (int r = 0; r < img.rows; r++) {
+        const uchar* row = img.ptr<uchar>(r);
+        const int* lab = labels.ptr<int>(r);
+        for (int c = 0; c < cols; c++) {
+            if (row[c] != 0 || lab[c] != 0) {
+                continue;
+            }
+            label++;
+            if (stats != nullptr) {
+                moments.emplace_back();
+            }
+            fillRow(r, c, c + 1);
+            while (!stack.empty()) {
+                const Span span = stack.back();
+                stack.pop_back();
+                if (span.row > 0) {
+                    fillRow(span.row - 1, span.begin - reach, span.end + reach);
+                }
+                if (span.row + 1 < img.rows) {
+                    fillRow(span.row + 1, span.begin - reach, span.end + reach);
+                }
+            }
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->assign(moments);
+    }
+    return label;
+}
+
+template int Labeling::floodFill<Connectivity::Four>(const cv::Mat& img, cv::Mat& labels, ComponentStats* stats);
+template int Labeling::floodFill<Connectivity::Eight>(const cv::Mat& img, cv::Mat& labels, ComponentStats* stats);
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "ComponentStats.h"
+
+class UnionFind;
+
+enum class Connectivity { Four = 4, Eight = 8 };
+
+// Connected component labeling of the black (0) pixels of a binary image.
+// Labels are CV_32S, 0 is background and components are numbered from 1 in
+// the raster order of their first pixel. Every labeler can also fill a
+// ComponentStats table while it labels, without another pass over the image.
+class Labeling {
+public:
+    // Two-pass labeling with an array-based union-find and the scan decision
+    // tree of Wu et al. (SAUF), 8-connected. When firstPass is given it
+    // receives the provisional labels of the first scan. Returns the number
+    // of components.
+    static int unionFind(const cv::Mat& img, cv::Mat& labels, cv::Mat* firstPass = nullptr,
+                         ComponentStats* stats = nullptr);
+
+    // Same result as unionFind (or its 4-connected counterpart), computed on
+    // horizontal stripes in parallel. Stripe seams are joined with a
+    // lock-free union-find and labels stay in raster order for any number
+    // of threads.
+    static int parallelUnionFind(const cv::Mat& img, cv::Mat& labels,
+                                 Connectivity connectivity = Connectivity::Eight,
+                                 ComponentStats* stats = nullptr);
+
+    // Scanline flood fill that walks contiguous runs, sharing one span stack
+    // across all components. Gives the same labels as bfs for
+    // Connectivity::Eight.
+    template<Connectivity C>
+    static int floodFill(const cv::Mat& img, cv::Mat& labels, ComponentStats* stats = nullptr);
+
+private:
+    struct Span {
+        int row;
+        int begin;
+        int end;
+    };
+
+    template<Connectivity C>
+    static int labelStripes(const cv::Mat& img, cv::Mat& labels, ComponentStats* stats);
+    // moments, when given, is indexed by label - firstLabel.
+    template<Connectivity C>
+    static int scanRows(const cv::Mat& img, cv::Mat& labels, UnionFind& equivalences,
+                        int rowBegin, int rowEnd, int firstLabel, std::vector<ComponentMoments>* moments);
+    template<Connectivity C>
+    static void mergeSeam(const cv::Mat& img, const cv::Mat& labels, UnionFind& equivalences, int row);
+    static void relabelRows(cv::Mat& labels, const UnionFind& equivalences, int rowBegin, int rowEnd);
+    // moments[i - begin] holds provisional label i.
+    static void collectStats(const std::vector<ComponentMoments>& moments, const UnionFind& equivalences,
+                             int begin, int end, std::vector<ComponentMoments>& components);
+};
@@ -0,0 +1,198 @@
+#include "RunLength.h"
+#include "UnionFind.h"
+
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+
+void RunLength::encodeRow(const uchar* row, const int r, const int cols, std::vector<PixelRun>& runs) {
+    int c = 0;
+    while (c < cols) {
+        const auto* black = static_cast<const uchar*>(std::memchr(row + c, 0, cols - c));
+        if (black == nullptr) {
+            return;
+        }
+        const int begin = static_cast<int>(black - row);
+        int end = begin + 1;
+        while (end < cols && row[end] == 0) {
+            end++;
+        }
+        runs.push_back({r, begin, end});
+        c = end;
+    }
+}
+
+RleComponents RunLength::label(const cv::Mat& img, const Connectivity connectivity) {
+    CV_Assert(img.type() == CV_8UC1);
+
+    std::vector<PixelRun> runs;
+    std::vector<int> runLabels;
+    UnionFind equivalences;
+    int next = 1;
+
+    // Runs touching diagonally are joined under 8-connectivity.
+    const int reach = connectivity == Connectivity::Eight ? 1 : 0;
+    size_t prevBegin = 0;
+    size_t prevEnd = 0;
+
+    for (int r = 0; r < img.rows; r++) {
+        const size_t curBegin = runs.size();
+        encodeRow(img.ptr<uchar>(r), r, img.cols, runs);
+        const size_t curEnd = runs.size();
+        runLabels.resize(curEnd);
+
+        size_t p = prevBegin;
+        for (size_t i = curBegin; i < curEnd; i++) {
+            const PixelRun& run = runs[i];
+            while (p < prevEnd && runs[p].end + reach <= run.begin) {
+                p++;
+            }
+
+            int lab = 0;
+            for (size_t q = p; q < prevEnd && runs[q].begin < run.end + reach; q++) {
+                lab = lab == 0 ? runLabels[q] : equivalences.merge(lab, runLabels[q]);
+            }
+            if (lab == 0) {
+                equivalences.makeSet(next);
+                lab = next++;
+            }
+            runLabels[i] = lab;
+        }
+
+        prevBegin = curBegin;
+        prevEnd = curEnd;
+    }
+
+    RleComponents components;
+    components.rows = img.rows;
+    components.cols = img.cols;
+
+    const int count = equivalences.flatten(1, next, 1) - 1;
+    components.offsets.assign(count + 2, 0);
+    for (const int lab : runLabels) {
+        components.offsets[equivalences[lab] + 1]++;
+    }
+    for (int i = 1; i <= count + 1; i++) {
+        components.offsets[i] += components.offsets[i - 1];
+    }
+
+    components.runs.resize(runs.size());
+    std::vector<uint32_t> fill(components.offsets.begin(), components.offsets.end() - 1);
+    for (size_t i = 0; i < runs.size(); i++) {
+        components.runs[fill[equivalences[runLabels[i]]]++] = runs[i];
+    }
+    // Drop the slot reserved for label 0.
+    components.offsets.erase(components.offsets.begin());
+
+    return components;
+}
+
+cv::Mat RunLength::decode(const RleComponents& components) {
+    cv::Mat labels = cv::Mat::zeros(components.rows, components.cols, CV_32S);
+    for (int i = 0; i < components.size(); i++) {
+        for (uint32_t k = components.offsets[i]; k < components.offsets[i + 1]; k++) {
+            const PixelRun& run = components.runs[k];
+            int* lab = labels.ptr<int>(run.row);
+            std::fill(lab + run.begin, lab + run.end, i + 1);
+        }
+    }
+    return labels;
+}
+
+void RunLength::writeVarint(std::vector<uchar>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uchar>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uchar>(value));
+}
+
+bool RunLength::readVarint(const std::vector<uchar>& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < in.size(); shift += 7) {
+        const uchar byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RunLength::write(const std::string& path, const RleComponents& components) {
+    std::vector<uchar> out = {'R', 'L', 'E', '1'};
+    writeVarint(out, components.rows);
+    writeVarint(out, components.cols);
+    writeVarint(out, components.size());
+
+    for (int i = 0; i < components.size(); i++) {
+        writeVarint(out, components.offsets[i + 1] - components.offsets[i]);
+        int row = 0;
+        for (uint32_t k = components.offsets[i]; k < components.offsets[i + 1]; k++) {
+            const PixelRun& run = components.runs[k];
+            writeVarint(out, run.row - row);
+            writeVarint(out, run.begin);
+            writeVarint(out, run.end - run.begin);
+            row = run.row;
+        }
+    }
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    return file.good();
+}
+
+bool RunLength::read(const std::string& path, RleComponents& components) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::vector<uchar> in((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (in.size() < 4 || std::memcmp(in.data(), "RLE1", 4) != 0) {
+        return false;
+    }
+
+    size_t pos = 4;
+    uint64_t rows, cols, count;
+    if (!readVarint(in, pos, rows) || !readVarint(in, pos, cols) || !readVarint(in, pos, count)) {
+        return false;
+    }
+    // Every component takes at least one byte (its run count), so a larger
+    // count than bytes left can only come from a corrupt header.
+    if (rows > INT_MAX || cols > INT_MAX || count > in.size() - pos) {
+        return false;
+    }
+
+    RleComponents result;
+    result.rows = static_cast<int>(rows);
+    result.cols = static_cast<int>(cols);
+    result.offsets.reserve(count + 1);
+
+    for (uint64_t i = 0; i < count; i++) {
+        uint64_t runCount;
+        if (!readVarint(in, pos, runCount)) {
+            return false;
+        }
+        uint64_t row = 0;
+        for (uint64_t k = 0; k < runCount; k++) {
+            uint64_t delta, begin, length;
+            if (!readVarint(in, pos, delta) || !readVarint(in, pos, begin) || !readVarint(in, pos, length)) {
+                return false;
+            }
+            row += delta;
+            if (row >= rows || begin > cols || length > cols - begin) {
+                return false;
+            }
+            result.runs.push_back({static_cast<int>(row), static_cast<int>(begin), static_cast<int>(begin + length)});
+        }
+        result.offsets.push_back(static_cast<uint32_t>(result.runs.size()));
+    }
+
+    components = std::move(result);
+    return true;
+}
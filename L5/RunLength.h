@@ -0,0 +1,45 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Labeling.h"
+
+struct PixelRun {
+    int row;
+    int begin;
+    int end;
+};
+
+// Components stored as run lists: the runs of component i (0-based, label
+// i + 1) are runs[offsets[i]] .. runs[offsets[i + 1] - 1], in raster order.
+struct RleComponents {
+    int rows = 0;
+    int cols = 0;
+    std::vector<uint32_t> offsets{0};
+    std::vector<PixelRun> runs;
+
+    [[nodiscard]] int size() const { return static_cast<int>(offsets.size()) - 1; }
+};
+
+// Labeling on run-length encoded rows: each row is split into runs of black
+// pixels and overlapping runs of adjacent rows are joined, so the cost
+// depends on the number of runs rather than the number of pixels.
+class RunLength {
+public:
+    static RleComponents label(const cv::Mat& img, Connectivity connectivity = Connectivity::Eight);
+
+    // CV_32S label image equivalent to Labeling::unionFind.
+    static cv::Mat decode(const RleComponents& components);
+
+    // Binary format: "RLE1", rows, cols, component count, then per component
+    // its run count and runs as (row delta, begin, length), all LEB128 varints.
+    static bool write(const std::string& path, const RleComponents& components);
+    static bool read(const std::string& path, RleComponents& components);
+
+private:
+    static void encodeRow(const uchar* row, int r, int cols, std::vector<PixelRun>& runs);
+    static void writeVarint(std::vector<uchar>& out, uint64_t value);
+    static bool readVarint(const std::vector<uchar>& in, size_t& pos, uint64_t& value);
+};
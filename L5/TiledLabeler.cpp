@@ -0,0 +1,160 @@
+#include "TiledLabeler.h"
+#include "Labeling.h"
+#include "UnionFind.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+bool TiledLabeler::readHeader(std::ifstream& in, int& rows, int& cols) {
+    std::string magic;
+    in >> magic;
+    if (magic != "P5") {
+        return false;
+    }
+
+    int values[3];
+    for (int& value : values) {
+        in >> std::ws;
+        while (in.peek() == '#') {
+            std::string comment;
+            std::getline(in, comment);
+            in >> std::ws;
+        }
+        if (!(in >> value)) {
+            return false;
+        }
+    }
+    in.get();
+
+    cols = values[0];
+    rows = values[1];
+    return cols > 0 && rows > 0 && values[2] > 0 && values[2] < 256;
+}
+
+bool TiledLabeler::readBand(std::ifstream& in, cv::Mat& band) {
+    for (int r = 0; r < band.rows; r++) {
+        in.read(reinterpret_cast<char*>(band.ptr<uchar>(r)), band.cols);
+    }
+    return in.good();
+}
+
+void TiledLabeler::mergeCarry(const cv::Mat& carry, const cv::Mat& carryLabels, const cv::Mat& band,
+                              const cv::Mat& bandLabels, const int firstLabel, UnionFind& equivalences) {
+    const uchar* above = carry.ptr<uchar>(0);
+    const uchar* below = band.ptr<uchar>(0);
+    const int* labAbove = carryLabels.ptr<int>(0);
+    const int* labBelow = bandLabels.ptr<int>(0);
+
+    for (int c = 0; c < band.cols; c++) {
+        if (below[c] != 0) {
+            continue;
+        }
+        for (int k = std::max(0, c - 1); k <= std::min(band.cols - 1, c + 1); k++) {
+            if (above[k] == 0) {
+                equivalences.merge(firstLabel + labBelow[c] - 1, labAbove[k]);
+            }
+        }
+    }
+}
+
+bool TiledLabeler::label(const std::string& inputPath, const std::string& labelsPath,
+                         ComponentStats* stats, const int bandRows) {
+    std::ifstream in(inputPath, std::ios::binary);
+    int rows, cols;
+    if (!in.is_open() || !readHeader(in, rows, cols)) {
+        return false;
+    }
+    const std::streampos dataStart = in.tellg();
+
+    cv::Mat band(bandRows, cols, CV_8UC1);
+    cv::Mat bandLabels;
+    cv::Mat carry(1, cols, CV_8UC1);
+    cv::Mat carryLabels(1, cols, CV_32S);
+
+    // Every band component gets one global label; bands are joined through
+    // the union-find along the carried row.
+    UnionFind equivalences;
+    std::vector<int> bandOffsets;
+    int next = 1;
+
+    for (int y = 0; y < rows; y += bandRows) {
+        cv::Mat rowsMat = band.rowRange(0, std::min(bandRows, rows - y));
+        if (!readBand(in, rowsMat)) {
+            return false;
+        }
+        const int count = Labeling::unionFind(rowsMat, bandLabels);
+
+        bandOffsets.push_back(next);
+        for (int k = 0; k < count; k++) {
+            equivalences.makeSet(next + k);
+        }
+        if (y > 0) {
+            mergeCarry(carry, carryLabels, rowsMat, bandLabels, next, equivalences);
+        }
+
+        const int last = rowsMat.rows - 1;
+        rowsMat.row(last).copyTo(carry);
+        const int* lastLabels = bandLabels.ptr<int>(last);
+        int* carried = carryLabels.ptr<int>(0);
+        for (int c = 0; c < cols; c++) {
+            carried[c] = lastLabels[c] == 0 ? 0 : next + lastLabels[c] - 1;
+        }
+        next += count;
+    }
+
+    const int total = equivalences.flatten(1, next, 1) - 1;
+
+    // Second pass: relabel each band the same way and map it to final labels.
+    std::ofstream out;
+    if (!labelsPath.empty()) {
+        out.open(labelsPath, std::ios::binary);
+        if (!out.is_open()) {
+            return false;
+        }
+        const int32_t header[2] = {rows, cols};
+        out.write("LBL1", 4);
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+    }
+
+    in.clear();
+    in.seekg(dataStart);
+    std::vector<ComponentMoments> moments(stats != nullptr ? total : 0);
+    std::vector<int32_t> rowOut(cols);
+
+    for (int y = 0, b = 0; y < rows; y += bandRows, b++) {
+        cv::Mat rowsMat = band.rowRange(0, std::min(bandRows, rows - y));
+        if (!readBand(in, rowsMat)) {
+            return false;
+        }
+        Labeling::unionFind(rowsMat, bandLabels);
+
+        for (int r = 0; r < rowsMat.rows; r++) {
+            const int* lab = bandLabels.ptr<int>(r);
+            for (int c = 0; c < cols; c++) {
+                rowOut[c] = lab[c] == 0 ? 0 : equivalences[bandOffsets[b] + lab[c] - 1];
+            }
+
+            if (stats != nullptr) {
+                for (int c = 0; c < cols;) {
+                    const int begin = c;
+                    while (c < cols && rowOut[c] == rowOut[begin]) {
+                        c++;
+                    }
+                    if (rowOut[begin] != 0) {
+                        moments[rowOut[begin] - 1].addRun(y + r, begin, c);
+                    }
+                }
+            }
+            if (out.is_open()) {
+                out.write(reinterpret_cast<const char*>(rowOut.data()),
+                          static_cast<std::streamsize>(rowOut.size() * sizeof(int32_t)));
+            }
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->assign(moments);
+    }
+    return !out.is_open() || out.good();
+}
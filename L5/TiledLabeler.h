@@ -0,0 +1,27 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <fstream>
+#include <string>
+#include "ComponentStats.h"
+
+class UnionFind;
+
+// Out-of-core 8-connected labeling of a binary P5 PGM that does not fit in
+// memory. The image is read in horizontal bands; only the last row of the
+// previous band and a union-find over band components are kept between
+// bands, so peak memory is a couple of bands plus one entry per component.
+class TiledLabeler {
+public:
+    // Labels are written to labelsPath (skipped when empty) as "LBL1", the
+    // int32 rows and cols, then rows * cols int32 labels in raster order,
+    // identical to Labeling::unionFind. Returns false on I/O or format errors.
+    static bool label(const std::string& inputPath, const std::string& labelsPath,
+                      ComponentStats* stats = nullptr, int bandRows = 512);
+
+private:
+    static bool readHeader(std::ifstream& in, int& rows, int& cols);
+    static bool readBand(std::ifstream& in, cv::Mat& band);
+    static void mergeCarry(const cv::Mat& carry, const cv::Mat& carryLabels, const cv::Mat& band,
+                           const cv::Mat& bandLabels, int firstLabel, UnionFind& equivalences);
+};
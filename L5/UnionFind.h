@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// Array-based union-find over provisional labels. Every label points at a
+// label no larger than itself, so each root is the smallest label of its
+// set and roots keep the order in which labels were created.
+class UnionFind {
+public:
+    explicit UnionFind(const size_t capacity = 1) : parent(capacity, 0) {}
+
+    void makeSet(const int i) {
+        if (static_cast<size_t>(i) >= parent.size()) {
+            parent.resize(i + 1);
+        }
+        parent[i] = i;
+    }
+
+    int find(int i) const {
+        while (parent[i] < i) {
+            i = parent[i];
+        }
+        return i;
+    }
+
+    int merge(const int i, const int j) {
+        int root = find(i);
+        if (i != j) {
+            const int rootJ = find(j);
+            if (root > rootJ) {
+                root = rootJ;
+            }
+            setRoot(j, root);
+        }
+        setRoot(i, root);
+        return root;
+    }
+
+    // Lock-free variant of merge for joining sets from several threads at
+    // once: roots are linked by compare-and-swap and paths are not
+    // compressed, so it must not run concurrently with merge or flatten.
+    void mergeConcurrent(int i, int j) {
+        while (true) {
+            i = findConcurrent(i);
+            j = findConcurrent(j);
+            if (i == j) {
+                return;
+            }
+            if (i < j) {
+                std::swap(i, j);
+            }
+            int expected = i;
+            if (std::atomic_ref(parent[i]).compare_exchange_weak(expected, j)) {
+                return;
+            }
+        }
+    }
+
+    // Replaces every label in [begin, end) with its final consecutive label,
+    // continuing the numbering from next. Ranges must be flattened in
+    // increasing order. Returns the next unused final label.
+    int flatten(const int begin, const int end, int next) {
+        for (int i = begin; i < end; i++) {
+            if (parent[i] < i) {
+                parent[i] = parent[parent[i]];
+            } else {
+                parent[i] = next++;
+            }
+        }
+        return next;
+    }
+
+    int operator[](const int i) const { return parent[i]; }
+
+private:
+    std::vector<int> parent;
+
+    int findConcurrent(int i) {
+        while (true) {
+            const int p = std::atomic_ref(parent[i]).load(std::memory_order_acquire);
+            if (p == i) {
+                return i;
+            }
+            i = p;
+        }
+    }
+
+    void setRoot(int i, const int root) {
+        while (parent[i] < i) {
+            const int j = parent[i];
+            parent[i] = root;
+            i = j;
+        }
+        parent[i] = root;
+    }
+};
@@ -1,15 +1,20 @@
 #include <iostream>
+#include <cmath>
+#include <filesystem>
 #include <vector>
-#include <queue>
 #include <opencv2/core.hpp>
 #include <opencv2/highgui/highgui.hpp>
+#include "Labeling.h"
+#include "RunLength.h"
+#include "TiledLabeler.h"
 
 using namespace cv;
 
 
-Mat bfs(const Mat &img);
-std::pair<Mat,Mat> twoPass(const Mat &img);
+Mat bfs(const Mat &img, ComponentStats *stats = nullptr);
+std::pair<Mat,Mat> twoPass(const Mat &img, ComponentStats *stats = nullptr);
 Mat displayComponents(const Mat& labels, int numLabels);
+void printComponentStats(const ComponentStats &stats);
 
 int main() {
     const Mat img = imread("../images/letters.bmp", IMREAD_GRAYSCALE);
@@ -21,16 +26,24 @@ int main() {
     imshow("img", img);
     waitKey(0);
 
-    Mat bfsLabels = bfs(img);
-    auto [firstPass, secondPass] = twoPass(img);
+    ComponentStats bfsStats, twoPassStats;
+    Mat bfsLabels = bfs(img, &bfsStats);
+    auto [firstPass, secondPass] = twoPass(img, &twoPassStats);
+    Mat parallelLabels;
+    const int numLabelsParallel = Labeling::parallelUnionFind(img, parallelLabels);
+    const RleComponents rle = RunLength::label(img);
 
-    const int numLabelsBfs = *std::max_element(bfsLabels.begin<int>(), bfsLabels.end<int>());
+    const int numLabelsBfs = bfsStats.size();
     const int numLabelsFirstPass = *std::max_element(firstPass.begin<int>(), firstPass.end<int>());
-    const int numLabelsSecondPass = *std::max_element(secondPass.begin<int>(), secondPass.end<int>());
+    const int numLabelsSecondPass = twoPassStats.size();
+
+    printComponentStats(twoPassStats);
 
     const Mat bfsColored = displayComponents(bfsLabels, numLabelsBfs);
     const Mat firstPassColored = displayComponents(firstPass, numLabelsFirstPass);
     const Mat secondPassColored = displayComponents(secondPass, numLabelsSecondPass);
+    const Mat parallelColored = displayComponents(parallelLabels, numLabelsParallel);
+    const Mat rleColored = displayComponents(RunLength::decode(rle), rle.size());
 
     imshow("bfs", bfsColored);
     waitKey(0);
@@ -41,120 +54,52 @@ int main() {
     imshow("secondPass", secondPassColored);
     waitKey(0);
 
-    return 0;
-}
+    imshow("parallel", parallelColored);
+    waitKey(0);
 
-std::pair<Mat,Mat> twoPass(const Mat &img) {
-    int label = 0;
-    Mat labels = Mat::zeros(img.size(), CV_32S);
-    auto edges = std::vector<std::vector<int>>(1000);
-
-    constexpr int dx[] = {-1, -1, -1, 0};
-    constexpr int dy[] = {-1, 0, 1, -1};
-
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            if (img.at<uchar>(i,j) == 0 && labels.at<int>(i,j) == 0) {
-                auto L = std::vector<int>();
-
-                for (int k = 0; k < 4; k++) {
-                    const int x = i + dx[k];
-                    const int y = j + dy[k];
-                    if (x >= 0 && x < img.rows && y >= 0 && y < img.cols) {
-                        if (labels.at<int>(x, y) > 0) {
-                            L.push_back(labels.at<int>(x, y));
-                        }
-                    }
-                }
-
-                if (L.empty()) {
-                    label++;
-                    labels.at<int>(i, j) = label;
-                }
-                else {
-                    const int min = *std::ranges::min_element(L);
-                    labels.at<int>(i, j) = min;
-                    for (const auto &l : L) {
-                        if (l != min) {
-                            edges[l].push_back(min);
-                            edges[min].push_back(l);
-                        }
-                    }
-                }
-            }
-        }
-    }
+    std::cout << "RLE: " << rle.size() << " components, " << rle.runs.size() << " runs" << std::endl;
+    imshow("rle", rleColored);
+    waitKey(0);
 
-    const Mat firstPass = labels.clone();
-
-    int newLabel = 0;
-    auto newLabels = std::vector(label + 1, 0);
-
-    for (int i = 1; i < label; i++) {
-        if (newLabels[i] == 0) {
-            newLabel++;
-            std::queue<int> q;
-            newLabels[i] = newLabel;
-            q.push(i);
-            while (!q.empty()) {
-                const auto x = q.front();
-                q.pop();
-                for (const auto &edge : edges[x]) {
-                    if (newLabels[edge] == 0) {
-                        newLabels[edge] = newLabel;
-                        q.push(edge);
-                    }
-                }
-            }
-        }
+    ComponentStats tiledStats;
+    const std::filesystem::path tmp = std::filesystem::temp_directory_path();
+    const std::string pgm = (tmp / "letters.pgm").string();
+    const std::string lbl = (tmp / "letters.lbl").string();
+    if (imwrite(pgm, img) && TiledLabeler::label(pgm, lbl, &tiledStats, 64)) {
+        std::cout << "Tiled: " << tiledStats.size() << " components" << std::endl;
+    } else {
+        std::cerr << "Tiled labeling failed" << std::endl;
     }
+    std::error_code ignored;
+    std::filesystem::remove(pgm, ignored);
+    std::filesystem::remove(lbl, ignored);
 
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            labels.at<int>(i, j) = newLabels[labels.at<int>(i, j)];
-        }
-    }
+    return 0;
+}
 
+std::pair<Mat,Mat> twoPass(const Mat &img, ComponentStats *stats) {
+    Mat firstPass, labels;
+    Labeling::unionFind(img, labels, &firstPass, stats);
     return {firstPass, labels};
 }
 
-Mat bfs(const Mat &img) {
-    int label = 0;
-    Mat labels = Mat::zeros(img.size(), CV_32S);
-
-    constexpr int dx[] = {1, 1, 0, -1, -1, -1, 0, 1};
-    constexpr int dy[] = {0, 1, 1, 1, 0, -1, -1, -1};
-
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            if (img.at<uchar>(i, j) == 0 && labels.at<int>(i, j) == 0) {
-                label++;
-                std::queue<std::pair<int, int>> q;
-                labels.at<int>(i, j) = label;
-                q.emplace(i, j);
-
-                while (!q.empty()) {
-                    auto [fst, snd] = q.front();
-                    q.pop();
-
-                    for (int k = 0; k < 8; k++) {
-                        const int x = fst + dx[k];
-                        const int y = snd + dy[k];
-                        if (x >= 0 && x < img.rows && y >= 0 && y < img.cols) {
-                            if (img.at<uchar>(x, y) == 0 && labels.at<int>(x, y) == 0) {
-                                labels.at<int>(x, y) = label;
-                                q.emplace(x, y);
-                            }
-                        }
-                    }
-                }
-            }
-        }
-    }
-
+Mat bfs(const Mat &img, ComponentStats *stats) {
+    Mat labels;
+    Labeling::floodFill<Connectivity::Eight>(img, labels, stats);
     return labels;
 }
 
+void printComponentStats(const ComponentStats &stats) {
+    for (int i = 0; i < stats.size(); i++) {
+        const Rect &box = stats.boundingBox[i];
+        const double phi = atan2(2 * stats.mu11[i], stats.mu20[i] - stats.mu02[i]) / 2;
+        std::cout << "Component " << i + 1 << ": area " << stats.area[i]
+                  << ", bbox (" << box.x << ", " << box.y << ", " << box.width << "x" << box.height << ")"
+                  << ", centroid (" << stats.centroid[i].x << ", " << stats.centroid[i].y << ")"
+                  << ", orientation " << phi * 180 / CV_PI << std::endl;
+    }
+}
+
 Mat displayComponents(const Mat& labels, int numLabels) {
     std::vector<Vec3b> colors(numLabels + 1);
     colors[0] = Vec3b(255, 255, 255);
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Freeman chain code: 0 is east and codes turn counter-clockwise in 45
+// degree steps, with image rows growing downwards.
+struct ChainCode {
+    static constexpr int dx[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+    static constexpr int dy[8] = {0, -1, -1, -1, 0, 1, 1, 1};
+
+    static constexpr int eastSide = 1;
+    static constexpr int westSide = 2;
+
+    // East and west sides of a border pixel that face the region outside its
+    // border, given the codes entering and leaving it. A border tracer skips
+    // those neighbours counter-clockwise from where it came from to where it
+    // goes, so this holds for ContourTracer and extractBorder alike. Across
+    // the whole chain every row run [l, r] of the enclosed region yields one
+    // west side at l and one east side at r (reversed for hole borders).
+    static constexpr std::array<std::array<uint8_t, 8>, 8> sides = [] {
+        std::array<std::array<uint8_t, 8>, 8> table{};
+        for (int in = 0; in < 8; in++) {
+            for (int out = 0; out < 8; out++) {
+                for (int d = (in + 5) % 8; d != out; d = (d + 1) % 8) {
+                    table[in][out] |= d == 0 ? eastSide : d == 4 ? westSide : 0;
+                }
+            }
+        }
+        return table;
+    }();
+
+    cv::Point start;
+    std::vector<int> codes;
+};
@@ -0,0 +1,127 @@
+#include "ChainCodeFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr char magic[4] = {'F', 'C', 'C', '1'};
+    constexpr uint8_t packedMode = 0;
+    constexpr uint8_t runLengthMode = 1;
+    constexpr int maxRun = 32;
+}
+
+ChainCodeWriter::ChainCodeWriter(const std::string& path, const bool runLength)
+    : out(path, std::ios::binary), runLength(runLength) {
+    if (out.is_open()) {
+        out.write(magic, sizeof(magic));
+    }
+}
+
+bool ChainCodeWriter::write(const ChainCode& chain) {
+    const size_t n = chain.codes.size();
+
+    packed.assign((3 * n + 7) / 8, 0);
+    for (size_t i = 0; i < n; i++) {
+        const size_t bit = 3 * i;
+        const auto code = static_cast<unsigned>(chain.codes[i] & 7);
+        packed[bit / 8] |= static_cast<uint8_t>(code << (bit % 8));
+        if (bit % 8 > 5) {
+            packed[bit / 8 + 1] |= static_cast<uint8_t>(code >> (8 - bit % 8));
+        }
+    }
+
+    runs.clear();
+    if (runLength) {
+        for (size_t i = 0; i < n;) {
+            const int code = chain.codes[i] & 7;
+            int length = 1;
+            while (i + length < n && length < maxRun && (chain.codes[i + length] & 7) == code) {
+                length++;
+            }
+            runs.push_back(static_cast<uint8_t>(code | (length - 1) << 3));
+            i += length;
+        }
+    }
+
+    const bool useRuns = runLength && runs.size() < packed.size();
+    const std::vector<uint8_t>& payload = useRuns ? runs : packed;
+
+    const int32_t start[2] = {chain.start.x, chain.start.y};
+    const auto count = static_cast<uint32_t>(n);
+    const uint8_t mode = useRuns ? runLengthMode : packedMode;
+    const auto payloadSize = static_cast<uint32_t>(payload.size());
+
+    out.write(reinterpret_cast<const char*>(start), sizeof(start));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&mode), sizeof(mode));
+    out.write(reinterpret_cast<const char*>(&payloadSize), sizeof(payloadSize));
+    out.write(reinterpret_cast<const char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+    return out.good();
+}
+
+ChainCodeReader::ChainCodeReader(const std::string& path) : file(path, true) {
+    if (!file.isOpen() || file.size() < sizeof(magic) || std::memcmp(file.data(), magic, sizeof(magic)) != 0) {
+        return;
+    }
+    data = file.data();
+    size = file.size();
+    pos = sizeof(magic);
+}
+
+template<typename T>
+bool ChainCodeReader::read(T& value) {
+    if (pos + sizeof(T) > size) {
+        return false;
+    }
+    std::memcpy(&value, data + pos, sizeof(T));
+    pos += sizeof(T);
+    return true;
+}
+
+bool ChainCodeReader::next(ChainCode& chain) {
+    int32_t start[2];
+    uint32_t count, payloadSize;
+    uint8_t mode;
+    if (data == nullptr || !read(start[0]) || !read(start[1]) || !read(count) || !read(mode) ||
+        !read(payloadSize) || pos + payloadSize > size) {
+        return false;
+    }
+
+    // count comes from the file: check it against the payload before it
+    // sizes an allocation.
+    const bool consistent = mode == runLengthMode
+        ? count <= static_cast<uint64_t>(payloadSize) * maxRun
+        : mode == packedMode && payloadSize == (3 * static_cast<uint64_t>(count) + 7) / 8;
+    if (!consistent) {
+        return false;
+    }
+
+    const uint8_t* payload = data + pos;
+    pos += payloadSize;
+    chain.start = cv::Point(start[0], start[1]);
+    chain.codes.resize(count);
+
+    if (mode == runLengthMode) {
+        size_t i = 0;
+        for (uint32_t k = 0; k < payloadSize; k++) {
+            const int code = payload[k] & 7;
+            const size_t length = (payload[k] >> 3) + 1;
+            if (i + length > count) {
+                return false;
+            }
+            std::fill_n(chain.codes.begin() + static_cast<std::ptrdiff_t>(i), length, code);
+            i += length;
+        }
+        return i == count;
+    }
+
+    for (uint32_t i = 0; i < count; i++) {
+        const size_t bit = 3 * static_cast<size_t>(i);
+        unsigned value = payload[bit / 8] >> (bit % 8);
+        if (bit % 8 > 5) {
+            value |= payload[bit / 8 + 1] << (8 - bit % 8);
+        }
+        chain.codes[i] = static_cast<int>(value & 7);
+    }
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "ChainCode.h"
+#include "MappedFile.h"
+
+// Binary chain code archive: "FCC1" followed by one record per contour:
+// int32 start x, int32 start y, uint32 code count, uint8 mode, uint32
+// payload size and the payload. Mode 0 packs codes in 3 bits each, mode 1
+// stores one byte per run (code in the low 3 bits, run length - 1 above).
+class ChainCodeWriter {
+public:
+    explicit ChainCodeWriter(const std::string& path, bool runLength = true);
+
+    [[nodiscard]] bool isOpen() const { return out.is_open(); }
+    bool write(const ChainCode& chain);
+
+private:
+    std::ofstream out;
+    bool runLength;
+    std::vector<uint8_t> packed;
+    std::vector<uint8_t> runs;
+};
+
+// Reads an archive written by ChainCodeWriter through a read-only memory map.
+class ChainCodeReader {
+public:
+    explicit ChainCodeReader(const std::string& path);
+
+    [[nodiscard]] bool isOpen() const { return data != nullptr; }
+    bool next(ChainCode& chain);
+
+private:
+    MappedFile file;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    size_t pos = 0;
+
+    template<typename T>
+    bool read(T& value);
+};
@@ -0,0 +1,263 @@
+#include "ChainCodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr char magic[4] = {'F', 'C', 'R', '1'};
+
+    template<typename T>
+    void put(std::vector<uint8_t>& out, const T value) {
+        const size_t at = out.size();
+        out.resize(at + sizeof(T));
+        std::memcpy(out.data() + at, &value, sizeof(T));
+    }
+
+    // Encoder constants for one symbol. Division by the frequency is
+    // replaced by a multiply with its fixed-point reciprocal (Alverson's
+    // method), as in Giesen's reference rANS coder.
+    struct EncodeSymbol {
+        uint32_t limit = 0;
+        uint32_t reciprocal = 0;
+        uint32_t bias = 0;
+        uint32_t complement = 0;
+        uint32_t shift = 0;
+
+        EncodeSymbol() = default;
+
+        EncodeSymbol(const uint32_t start, const uint32_t freq, const int scaleBits, const uint32_t lowerBound)
+            : limit(((lowerBound >> scaleBits) << 8) * freq), complement((1u << scaleBits) - freq) {
+            if (freq < 2) {
+                reciprocal = ~0u;
+                bias = start + (1u << scaleBits) - 1;
+                return;
+            }
+            uint32_t bits = 0;
+            while (freq > 1u << bits) {
+                bits++;
+            }
+            reciprocal = static_cast<uint32_t>(((1ull << (bits + 31)) + freq - 1) / freq);
+            shift = bits - 1;
+            bias = start;
+        }
+
+        [[nodiscard]] uint32_t encode(const uint32_t x) const {
+            const auto q = static_cast<uint32_t>(static_cast<uint64_t>(x) * reciprocal >> 32) >> shift;
+            return x + bias + q * complement;
+        }
+    };
+
+    template<typename T>
+    T get(const uint8_t* p) {
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        return value;
+    }
+}
+
+void ChainCodec::normalize(const uint64_t counts[8], uint16_t freq[8]) {
+    constexpr int total = 1 << scaleBits;
+    uint64_t sum = 0;
+    for (int s = 0; s < 8; s++) {
+        sum += counts[s];
+    }
+
+    // Every symbol keeps a non-zero frequency; the remainder goes to the
+    // most frequent one.
+    int assigned = 0;
+    int largest = 0;
+    for (int s = 0; s < 8; s++) {
+        const uint64_t scaled = sum > 0 ? counts[s] * (total - 8) / sum : 0;
+        freq[s] = static_cast<uint16_t>(1 + scaled);
+        assigned += freq[s];
+        if (counts[s] > counts[largest]) {
+            largest = s;
+        }
+    }
+    freq[largest] = static_cast<uint16_t>(freq[largest] + total - assigned);
+}
+
+int ChainCodec::derivative(const std::vector<int>& codes, const size_t i) {
+    return (codes[i] - codes[i - 1]) & 7;
+}
+
+std::vector<uint8_t> ChainCodec::encode(const std::vector<ChainCode>& chains) {
+    // Derivative i is coded in the context of derivative i - 1; the first
+    // one assumes a straight run (context 0).
+    uint64_t counts[8][8] = {};
+    for (const ChainCode& chain : chains) {
+        int context = 0;
+        for (size_t i = 1; i < chain.codes.size(); i++) {
+            const int s = derivative(chain.codes, i);
+            counts[context][s]++;
+            context = s;
+        }
+    }
+
+    uint16_t freq[8][8];
+    EncodeSymbol symbols[8][8];
+    for (int context = 0; context < 8; context++) {
+        normalize(counts[context], freq[context]);
+        for (int s = 0, c = 0; s < 8; c += freq[context][s], s++) {
+            symbols[context][s] = EncodeSymbol(c, freq[context][s], scaleBits, lowerBound);
+        }
+    }
+
+    std::vector<uint8_t> out(magic, magic + sizeof(magic));
+    put(out, static_cast<uint32_t>(chains.size()));
+    for (const auto& row : freq) {
+        for (const uint16_t f : row) {
+            put(out, f);
+        }
+    }
+
+    const size_t indexBegin = out.size();
+    out.resize(indexBegin + entrySize * chains.size());
+
+    std::vector<uint8_t> stream;
+    for (size_t k = 0; k < chains.size(); k++) {
+        const auto& codes = chains[k].codes;
+        const size_t n = codes.size();
+
+        // rANS encodes backwards, so the stream is filled from its end. Each
+        // symbol emits at most two bytes, plus four per state at the end.
+        // Even and odd derivatives go to separate states, which lets the
+        // decoder work on two independent dependency chains.
+        stream.resize(2 * n + 8);
+        uint8_t* const streamEnd = stream.data() + stream.size();
+        uint8_t* p = streamEnd;
+        if (n > 1) {
+            uint32_t x[2] = {lowerBound, lowerBound};
+            int s = derivative(codes, n - 1);
+            for (size_t i = n - 1; i >= 1; i--) {
+                const int context = i > 1 ? derivative(codes, i - 1) : 0;
+                const EncodeSymbol& symbol = symbols[context][s];
+                uint32_t& state = x[i & 1];
+                while (state >= symbol.limit) {
+                    *--p = static_cast<uint8_t>(state & 0xFF);
+                    state >>= 8;
+                }
+                state = symbol.encode(state);
+                s = context;
+            }
+            for (int j = 1; j >= 0; j--) {
+                p -= 4;
+                std::memcpy(p, &x[j], 4);
+            }
+        }
+
+        uint8_t* entry = out.data() + indexBegin + entrySize * k;
+        const int32_t start[2] = {chains[k].start.x, chains[k].start.y};
+        const auto codeCount = static_cast<uint32_t>(n);
+        const auto first = static_cast<uint8_t>(n > 0 ? codes[0] & 7 : 0);
+        const auto offset = static_cast<uint64_t>(out.size());
+        const auto streamSize = static_cast<uint32_t>(streamEnd - p);
+        std::memcpy(entry, start, 8);
+        std::memcpy(entry + 8, &codeCount, 4);
+        std::memcpy(entry + 12, &first, 1);
+        std::memcpy(entry + 13, &offset, 8);
+        std::memcpy(entry + 21, &streamSize, 4);
+
+        out.insert(out.end(), p, streamEnd);
+    }
+
+    return out;
+}
+
+bool ChainCodec::write(const std::string& path, const std::vector<ChainCode>& chains) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    const std::vector<uint8_t> bytes = encode(chains);
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return file.good();
+}
+
+ChainCodecReader::ChainCodecReader(const std::string& path) : file(path) {
+    if (!file.isOpen() || file.size() < ChainCodec::headerSize) {
+        return;
+    }
+
+    const uint8_t* bytes = file.data();
+    fileSize = file.size();
+    count = get<uint32_t>(bytes + 4);
+
+    bool valid = std::memcmp(bytes, magic, sizeof(magic)) == 0 &&
+                 fileSize >= ChainCodec::headerSize + ChainCodec::entrySize * count;
+    for (int context = 0; context < 8; context++) {
+        int total = 0;
+        for (int s = 0; s < 8; s++) {
+            freq[context][s] = get<uint16_t>(bytes + 8 + 2 * (8 * context + s));
+            cumFreq[context][s] = static_cast<uint16_t>(total);
+            total += freq[context][s];
+        }
+        valid = valid && total == 1 << ChainCodec::scaleBits;
+    }
+
+    if (!valid) {
+        count = 0;
+        return;
+    }
+
+    for (int context = 0; context < 8; context++) {
+        for (int s = 0; s < 8; s++) {
+            std::fill_n(symbolOf[context] + cumFreq[context][s], freq[context][s], static_cast<uint8_t>(s));
+        }
+    }
+    data = bytes;
+}
+
+bool ChainCodecReader::decode(const size_t index, ChainCode& chain) const {
+    if (data == nullptr || index >= count) {
+        return false;
+    }
+
+    const uint8_t* entry = data + ChainCodec::headerSize + ChainCodec::entrySize * index;
+    const auto n = get<uint32_t>(entry + 8);
+    const auto offset = get<uint64_t>(entry + 13);
+    const auto streamSize = get<uint32_t>(entry + 21);
+    if (offset > fileSize || streamSize > fileSize - offset) {
+        return false;
+    }
+
+    chain.start = cv::Point(get<int32_t>(entry), get<int32_t>(entry + 4));
+    chain.codes.resize(n);
+    if (n == 0) {
+        return true;
+    }
+
+    int* codes = chain.codes.data();
+    codes[0] = entry[12] & 7;
+    if (n == 1) {
+        return true;
+    }
+
+    if (streamSize < 8) {
+        return false;
+    }
+
+    constexpr uint32_t mask = (1u << ChainCodec::scaleBits) - 1;
+    const uint8_t* p = data + offset;
+    const uint8_t* end = p + streamSize;
+    uint32_t x[2] = {get<uint32_t>(p), get<uint32_t>(p + 4)};
+    p += 8;
+
+    int code = codes[0];
+    int context = 0;
+    for (uint32_t i = 1; i < n; i++) {
+        uint32_t& state = x[i & 1];
+        const uint32_t slot = state & mask;
+        const int s = symbolOf[context][slot];
+        state = freq[context][s] * (state >> ChainCodec::scaleBits) + slot - cumFreq[context][s];
+        while (state < ChainCodec::lowerBound && p < end) {
+            state = state << 8 | *p++;
+        }
+        code = (code + s) & 7;
+        codes[i] = code;
+        context = s;
+    }
+
+    return true;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ChainCode.h"
+#include "MappedFile.h"
+
+// Entropy-coded chain code archive. Each contour keeps its first code and
+// stores the rest as derivatives (the turn from the previous code), which
+// on smooth borders are mostly 0, 1 and 7. Derivatives are compressed with
+// two interleaved byte-wise rANS states, using frequencies conditioned on
+// the previous derivative and shared by the whole archive.
+//
+// Layout: "FCR1", uint32 contour count, uint16 frequencies[8][8] (each row
+// sums to 4096), one index entry per contour (int32 start x, int32 start y,
+// uint32 code count, uint8 first code, uint64 stream offset, uint32 stream
+// size) and then the streams, so any contour can be decoded on its own.
+class ChainCodec {
+public:
+    static std::vector<uint8_t> encode(const std::vector<ChainCode>& chains);
+    static bool write(const std::string& path, const std::vector<ChainCode>& chains);
+
+private:
+    friend class ChainCodecReader;
+
+    static constexpr int scaleBits = 12;
+    static constexpr uint32_t lowerBound = 1u << 23;
+    static constexpr size_t headerSize = 4 + 4 + 64 * 2;
+    static constexpr size_t entrySize = 4 + 4 + 4 + 1 + 8 + 4;
+
+    static void normalize(const uint64_t counts[8], uint16_t freq[8]);
+    static int derivative(const std::vector<int>& codes, size_t i);
+};
+
+// Reads an archive written by ChainCodec through a read-only memory map.
+class ChainCodecReader {
+public:
+    explicit ChainCodecReader(const std::string& path);
+
+    [[nodiscard]] bool isOpen() const { return data != nullptr; }
+    [[nodiscard]] size_t size() const { return count; }
+    bool decode(size_t index, ChainCode& chain) const;
+
+private:
+    MappedFile file;
+    const uint8_t* data = nullptr;
+    size_t fileSize = 0;
+    size_t count = 0;
+
+    uint16_t freq[8][8] = {};
+    uint16_t cumFreq[8][8] = {};
+    uint8_t symbolOf[8][1 << ChainCodec::scaleBits] = {};
+};
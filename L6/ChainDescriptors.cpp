@@ -0,0 +1,92 @@
+#include "ChainDescriptors.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace {
+    // Prefix sums F(x) = sum of f(t) for t = 0 .. x, used by the discrete
+    // Green's theorem: each row run [l, r] of the region contributes
+    // F(r) - F(l - 1), with r found on east sides and l on west sides.
+    struct RowSums {
+        int64_t m00 = 0, m10 = 0, m01 = 0, m20 = 0, m02 = 0, m11 = 0;
+
+        void add(const int64_t x, const int64_t y, const int sign) {
+            const int64_t count = x + 1;
+            const int64_t sumX = x * (x + 1) / 2;
+            const int64_t sumXX = x * (x + 1) * (2 * x + 1) / 6;
+            m00 += sign * count;
+            m10 += sign * sumX;
+            m01 += sign * y * count;
+            m20 += sign * sumXX;
+            m02 += sign * y * y * count;
+            m11 += sign * y * sumX;
+        }
+    };
+}
+
+ShapeDescriptors ChainDescriptors::compute(const ChainCode& chain) {
+    const auto& codes = chain.codes;
+    const size_t n = codes.size();
+
+    RowSums sums;
+    int even = 0;
+    int odd = 0;
+    int minX = chain.start.x, maxX = chain.start.x;
+    int minY = chain.start.y, maxY = chain.start.y;
+
+    if (n == 0) {
+        sums.add(chain.start.x, chain.start.y, 1);
+        sums.add(chain.start.x - 1, chain.start.y, -1);
+    }
+
+    cv::Point p = chain.start;
+    for (size_t i = 0; i < n; i++) {
+        const int sides = ChainCode::sides[codes[(i + n - 1) % n] & 7][codes[i] & 7];
+        if (sides & ChainCode::eastSide) {
+            sums.add(p.x, p.y, 1);
+        }
+        if (sides & ChainCode::westSide) {
+            sums.add(p.x - 1, p.y, -1);
+        }
+
+        const int code = codes[i] & 7;
+        (code % 2 == 0 ? even : odd)++;
+        p.x += ChainCode::dx[code];
+        p.y += ChainCode::dy[code];
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+
+    // Hole borders run the other way round and yield negative sums.
+    if (sums.m00 < 0) {
+        sums.m00 = -sums.m00;
+        sums.m10 = -sums.m10;
+        sums.m01 = -sums.m01;
+        sums.m20 = -sums.m20;
+        sums.m02 = -sums.m02;
+        sums.m11 = -sums.m11;
+    }
+
+    ShapeDescriptors descriptors;
+    descriptors.area = static_cast<int>(sums.m00);
+    descriptors.perimeter = even + odd * M_SQRT2;
+    descriptors.boundingBox = cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+    if (sums.m00 == 0) {
+        return descriptors;
+    }
+
+    const auto area = static_cast<double>(sums.m00);
+    const double cx = static_cast<double>(sums.m10) / area;
+    const double cy = static_cast<double>(sums.m01) / area;
+    descriptors.centroid = cv::Point2d(cx, cy);
+
+    const double mcc = static_cast<double>(sums.m20) - cx * static_cast<double>(sums.m10);
+    const double mrr = static_cast<double>(sums.m02) - cy * static_cast<double>(sums.m01);
+    const double mrc = static_cast<double>(sums.m11) - cx * static_cast<double>(sums.m01);
+    descriptors.elongation = atan2(2 * mrc, mcc - mrr) / 2;
+
+    return descriptors;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include "ChainCode.h"
+
+struct ShapeDescriptors {
+    int area = 0;
+    double perimeter = 0.0;
+    cv::Rect boundingBox;
+    cv::Point2d centroid;
+    double elongation = 0.0;
+};
+
+// Shape descriptors computed from a closed chain code in O(length), without
+// rasterizing it. The chain must be traced counter-clockwise on screen, as
+// ContourTracer and extractBorder do. Area, centroid and elongation are exact
+// pixel moments of everything the border encloses: an outer border counts
+// itself and its holes, a hole border counts the hole and whatever is nested
+// in it. Perimeter weights odd codes by sqrt(2).
+class ChainDescriptors {
+public:
+    static ShapeDescriptors compute(const ChainCode& chain);
+};
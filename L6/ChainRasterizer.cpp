@@ -0,0 +1,118 @@
+#include "ChainRasterizer.h"
+
+#include <algorithm>
+
+ChainRasterizer::EdgeTable ChainRasterizer::buildEdgeTable(const std::vector<Contour>& contours, const int rows) {
+    EdgeTable table;
+    table.offsets.assign(rows + 1, 0);
+
+    // Two passes over every chain: count the run ends per row, then place
+    // them, so that each row's edges are contiguous.
+    const auto forEachEdge = [&](const auto& emit) {
+        for (int i = 0; i < static_cast<int>(contours.size()); i++) {
+            const ChainCode& chain = contours[i].chain;
+            const auto& codes = chain.codes;
+            const size_t n = codes.size();
+            cv::Point p = chain.start;
+
+            if (n == 0) {
+                if (p.y >= 0 && p.y < rows) {
+                    emit(p.y, Edge{p.x, i});
+                    emit(p.y, Edge{p.x + 1, i});
+                }
+                continue;
+            }
+
+            for (size_t k = 0; k < n; k++) {
+                if (p.y >= 0 && p.y < rows) {
+                    const int sides = ChainCode::sides[codes[(k + n - 1) % n] & 7][codes[k] & 7];
+                    if (sides & ChainCode::westSide) {
+                        emit(p.y, Edge{p.x, i});
+                    }
+                    if (sides & ChainCode::eastSide) {
+                        emit(p.y, Edge{p.x + 1, i});
+                    }
+                }
+                p.x += ChainCode::dx[codes[k] & 7];
+                p.y += ChainCode::dy[codes[k] & 7];
+            }
+        }
+    };
+
+    forEachEdge([&](const int y, const Edge&) { table.offsets[y + 1]++; });
+    for (int y = 0; y < rows; y++) {
+        table.offsets[y + 1] += table.offsets[y];
+    }
+
+    table.edges.resize(table.offsets[rows]);
+    std::vector<int> next(table.offsets.begin(), table.offsets.end() - 1);
+    forEachEdge([&](const int y, const Edge& edge) { table.edges[next[y]++] = edge; });
+
+    return table;
+}
+
+template<typename Pixel, typename Paint>
+void ChainRasterizer::fillBands(const EdgeTable& table, cv::Mat& out, const bool byContour, const Paint& paint) {
+    const int bands = std::max(1, std::min(out.rows, cv::getNumThreads() * 4));
+
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        std::vector<Edge> row;
+        for (int b = range.start; b < range.end; b++) {
+            const int rowBegin = out.rows * b / bands;
+            const int rowEnd = out.rows * (b + 1) / bands;
+
+            for (int y = rowBegin; y < rowEnd; y++) {
+                row.assign(table.edges.begin() + table.offsets[y], table.edges.begin() + table.offsets[y + 1]);
+                if (byContour) {
+                    std::ranges::sort(row, {}, [](const Edge& e) { return std::pair(e.contour, e.x); });
+                } else {
+                    std::ranges::sort(row, {}, &Edge::x);
+                }
+
+                Pixel* dst = out.ptr<Pixel>(y);
+                for (size_t k = 0; k + 1 < row.size(); k += 2) {
+                    const int begin = std::max(row[k].x, 0);
+                    const int end = std::min(row[k + 1].x, out.cols);
+                    if (begin < end) {
+                        paint(dst, begin, end, row[k].contour);
+                    }
+                }
+            }
+        }
+    });
+}
+
+cv::Mat ChainRasterizer::mask(const std::vector<Contour>& contours, const cv::Size size, const FillRule rule) {
+    cv::Mat out(size, CV_8UC1, cv::Scalar(255));
+    const EdgeTable table = buildEdgeTable(contours, size.height);
+
+    if (rule == FillRule::EvenOdd) {
+        fillBands<uchar>(table, out, false, [](uchar* dst, const int begin, const int end, int) {
+            std::fill(dst + begin, dst + end, 0);
+        });
+    } else {
+        fillBands<uchar>(table, out, true, [&](uchar* dst, const int begin, const int end, const int contour) {
+            std::fill(dst + begin, dst + end, contours[contour].hole ? 255 : 0);
+        });
+    }
+
+    return out;
+}
+
+cv::Mat ChainRasterizer::labels(const std::vector<Contour>& contours, const cv::Size size) {
+    std::vector<int> label(contours.size(), 0);
+    int next = 0;
+    for (size_t i = 0; i < contours.size(); i++) {
+        if (!contours[i].hole) {
+            label[i] = ++next;
+        }
+    }
+
+    cv::Mat out(size, CV_32SC1, cv::Scalar(0));
+    const EdgeTable table = buildEdgeTable(contours, size.height);
+    fillBands<int>(table, out, true, [&](int* dst, const int begin, const int end, const int contour) {
+        std::fill(dst + begin, dst + end, label[contour]);
+    });
+
+    return out;
+}
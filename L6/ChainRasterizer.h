@@ -0,0 +1,45 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "ContourTracer.h"
+
+enum class FillRule {
+    // Every border toggles the pixels it encloses; hole flags are ignored.
+    EvenOdd,
+    // Contours are painted parents first (as traceAll orders them): outer
+    // borders fill their region, hole borders clear theirs.
+    Hierarchy
+};
+
+// Batch polygon fill of closed chain codes. Each chain step contributes the
+// row-run ends it exposes (see ChainCode::sides) to a per-row edge table,
+// and row bands are then filled on separate threads. Chains may run off the
+// canvas; they are clipped.
+class ChainRasterizer {
+public:
+    // Filled regions as black (0) on white (255).
+    static cv::Mat mask(const std::vector<Contour>& contours, cv::Size size, FillRule rule = FillRule::Hierarchy);
+
+    // CV_32S label image: the n-th outer border gets label n, numbered from
+    // 1, and background is 0. With traceAll contours this reproduces
+    // 8-connected labeling.
+    static cv::Mat labels(const std::vector<Contour>& contours, cv::Size size);
+
+private:
+    // Run ends in a row: pixels from x on are toggled by the given contour.
+    struct Edge {
+        int x;
+        int contour;
+    };
+
+    struct EdgeTable {
+        std::vector<int> offsets;
+        std::vector<Edge> edges;
+    };
+
+    static EdgeTable buildEdgeTable(const std::vector<Contour>& contours, int rows);
+
+    template<typename Pixel, typename Paint>
+    static void fillBands(const EdgeTable& table, cv::Mat& out, bool byContour, const Paint& paint);
+};
@@ -0,0 +1,129 @@
+#include "ContourTracer.h"
+
+#include <cstdlib>
+
+int ContourTracer::directionOf(const int dr, const int dc) {
+    for (int d = 0; d < 8; d++) {
+        if (ChainCode::dy[d] == dr && ChainCode::dx[d] == dc) {
+            return d;
+        }
+    }
+    return -1;
+}
+
+void ContourTracer::follow(cv::Mat& f, const int r, const int c, const int r2, const int c2, const int nbd,
+                           ChainCode& chain) {
+    // Search clockwise around the start pixel for its last border neighbour.
+    const int startDir = directionOf(r2 - r, c2 - c);
+    int r1 = -1, c1 = -1;
+    for (int k = 0; k < 8; k++) {
+        const int d = (startDir - k + 8) % 8;
+        if (f.at<int>(r + ChainCode::dy[d], c + ChainCode::dx[d]) != 0) {
+            r1 = r + ChainCode::dy[d];
+            c1 = c + ChainCode::dx[d];
+            break;
+        }
+    }
+    if (r1 < 0) {
+        f.at<int>(r, c) = -nbd;
+        return;
+    }
+
+    int pr = r1, pc = c1;
+    int cr = r, cc = c;
+    while (true) {
+        // Search counter-clockwise around the current pixel, starting after the previous one.
+        const int prevDir = directionOf(pr - cr, pc - cc);
+        bool eastZero = false;
+        int d = prevDir;
+        for (int k = 1; k <= 8; k++) {
+            d = (prevDir + k) % 8;
+            if (f.at<int>(cr + ChainCode::dy[d], cc + ChainCode::dx[d]) != 0) {
+                break;
+            }
+            if (d == 0) {
+                eastZero = true;
+            }
+        }
+
+        int& value = f.at<int>(cr, cc);
+        if (eastZero) {
+            value = -nbd;
+        } else if (value == 1) {
+            value = nbd;
+        }
+
+        chain.codes.push_back(d);
+        const int nr = cr + ChainCode::dy[d];
+        const int nc = cc + ChainCode::dx[d];
+        if (nr == r && nc == c && cr == r1 && cc == c1) {
+            return;
+        }
+        pr = cr;
+        pc = cc;
+        cr = nr;
+        cc = nc;
+    }
+}
+
+std::vector<Contour> ContourTracer::traceAll(const cv::Mat& img) {
+    CV_Assert(img.type() == CV_8UC1);
+
+    // Foreground is 1 inside a one pixel background frame.
+    cv::Mat f = cv::Mat::zeros(img.rows + 2, img.cols + 2, CV_32S);
+    for (int r = 0; r < img.rows; r++) {
+        const uchar* row = img.ptr<uchar>(r);
+        int* out = f.ptr<int>(r + 1) + 1;
+        for (int c = 0; c < img.cols; c++) {
+            out[c] = row[c] != 255 ? 1 : 0;
+        }
+    }
+
+    // Border numbers start at 2; 1 is the frame, which acts as a hole border.
+    std::vector<Contour> contours;
+    const auto isHole = [&](const int nbd) { return nbd == 1 || contours[nbd - 2].hole; };
+    const auto parentOf = [&](const int nbd) { return nbd == 1 ? -1 : contours[nbd - 2].parent; };
+
+    for (int r = 1; r <= img.rows; r++) {
+        int lnbd = 1;
+        for (int c = 1; c <= img.cols; c++) {
+            const int value = f.at<int>(r, c);
+            if (value == 0) {
+                continue;
+            }
+
+            bool outer = false;
+            bool hole = false;
+            if (value == 1 && f.at<int>(r, c - 1) == 0) {
+                outer = true;
+            } else if (value >= 1 && f.at<int>(r, c + 1) == 0) {
+                hole = true;
+                if (value > 1) {
+                    lnbd = value;
+                }
+            }
+
+            if (outer || hole) {
+                const int nbd = static_cast<int>(contours.size()) + 2;
+                Contour contour;
+                contour.hole = hole;
+                if (outer) {
+                    contour.parent = isHole(lnbd) ? lnbd - 2 : parentOf(lnbd);
+                } else {
+                    contour.parent = isHole(lnbd) ? parentOf(lnbd) : lnbd - 2;
+                }
+                contour.chain.start = cv::Point(c - 1, r - 1);
+                contours.push_back(contour);
+
+                follow(f, r, c, r, outer ? c - 1 : c + 1, nbd, contours.back().chain);
+            }
+
+            const int updated = f.at<int>(r, c);
+            if (updated != 1) {
+                lnbd = std::abs(updated);
+            }
+        }
+    }
+
+    return contours;
+}
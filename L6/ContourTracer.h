@@ -0,0 +1,25 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "ChainCode.h"
+
+struct Contour {
+    ChainCode chain;
+    bool hole = false;
+    int parent = -1;
+};
+
+// Border following of Suzuki and Abe (1985): one raster scan finds every
+// outer and hole border of the non-white (!= 255) pixels, 8-connected.
+// Chains are closed (they end back at their start point), outer borders
+// run counter-clockwise on screen and each contour records the index of
+// the contour that encloses it, or -1.
+class ContourTracer {
+public:
+    static std::vector<Contour> traceAll(const cv::Mat& img);
+
+private:
+    static int directionOf(int dr, int dc);
+    static void follow(cv::Mat& f, int r, int c, int r2, int c2, int nbd, ChainCode& chain);
+};
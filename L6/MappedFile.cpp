@@ -0,0 +1,60 @@
+#include "MappedFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define MAPPED_FILE_POSIX 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+#ifdef MAPPED_FILE_POSIX
+MappedFile::MappedFile(const std::string& path, const bool sequential) {
+    fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        return;
+    }
+
+    void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) {
+        return;
+    }
+    if (sequential) {
+        madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+    }
+
+    bytes = static_cast<const uint8_t*>(mapped);
+    length = static_cast<size_t>(info.st_size);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes != nullptr) {
+        munmap(const_cast<uint8_t*>(bytes), length);
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+#else
+MappedFile::MappedFile(const std::string& path, bool) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return;
+    }
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (!buffer.empty()) {
+        bytes = buffer.data();
+        length = buffer.size();
+    }
+}
+
+MappedFile::~MappedFile() = default;
+#endif
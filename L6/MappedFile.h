@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A whole file, read-only, for as long as the object lives. POSIX builds map
+// it into memory; elsewhere it is read into a buffer. A missing or empty
+// file leaves the object closed.
+class MappedFile {
+public:
+    // sequential hints that the file will be read front to back.
+    explicit MappedFile(const std::string& path, bool sequential = false);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    [[nodiscard]] bool isOpen() const { return bytes != nullptr; }
+    [[nodiscard]] const uint8_t* data() const { return bytes; }
+    [[nodiscard]] size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+    int fd = -1;
+    std::vector<uint8_t> buffer;
+};
@@ -1,7 +1,13 @@
 #include <opencv2/opencv.hpp>
 #include <iostream>
 #include <vector>
+#include <filesystem>
 #include <fstream>
+#include "ChainCodec.h"
+#include "ChainCodeFile.h"
+#include "ChainDescriptors.h"
+#include "ChainRasterizer.h"
+#include "ContourTracer.h"
 
 using namespace cv;
 using namespace std;
@@ -12,12 +18,23 @@ constexpr int dy[8] = {0, -1, -1, -1, 0, 1, 1, 1};
 Point findStartingPoint(const Mat &img);
 vector<int> computeDerivative(const vector<int> &chain);
 void extractBorder();
+void extractAllBorders();
 void reconstructFromFile(const string &chainCodeFile, const string &backgroundFile);
+bool readChainCodeText(const string &chainCodeFile, ChainCode &chain);
+bool convertToBinary(const string &textFile, const string &binaryFile);
 void reconstructBorder(Mat &img, const Point &startPoint, const vector<int> &chainCode);
 
 int main() {
     // extractBorder();
-    reconstructFromFile("../images/reconstruct.txt", "../images/gray_background.bmp");
+    extractAllBorders();
+    const string binary = (filesystem::temp_directory_path() / "reconstruct.fcc").string();
+    if (!convertToBinary("../images/reconstruct.txt", binary)) {
+        cerr << "Could not convert chain code file" << endl;
+        return 1;
+    }
+    reconstructFromFile(binary, "../images/gray_background.bmp");
+    error_code ignored;
+    filesystem::remove(binary, ignored);
     return 0;
 }
 
@@ -40,22 +57,16 @@ void reconstructBorder(Mat &img, const Point &startPoint, const vector<int> &cha
     }
 }
 
-void reconstructFromFile(const string &chainCodeFile, const string &backgroundFile) {
-    Mat img = imread(backgroundFile, IMREAD_GRAYSCALE);
-    if (img.empty()) {
-        cerr << "Could not read the background image: " << backgroundFile << endl;
-        return;
-    }
-
+bool readChainCodeText(const string &chainCodeFile, ChainCode &chain) {
     ifstream file(chainCodeFile);
     if (!file.is_open()) {
         cerr << "Could not open chain code file: " << chainCodeFile << endl;
-        return;
+        return false;
     }
 
     int startX, startY;
     file >> startX >> startY;
-    Point startPoint(startX, startY);
+    chain.start = Point(startX, startY);
 
     string line;
     getline(file, line);
@@ -65,18 +76,60 @@ void reconstructFromFile(const string &chainCodeFile, const string &backgroundFi
 
     getline(file, line);
 
-    vector<int> chainCode;
+    chain.codes.clear();
+    chain.codes.reserve(chainCodeCount);
     int code;
     while (file >> code) {
-        chainCode.push_back(code);
+        chain.codes.push_back(code);
     }
     file.close();
 
-    cout << "Starting point: (" << startPoint.x << ", " << startPoint.y << ")" << endl;
     cout << "Chain code count from file: " << chainCodeCount << endl;
-    cout << "Chain code length: " << chainCode.size() << endl;
+    return true;
+}
+
+bool convertToBinary(const string &textFile, const string &binaryFile) {
+    ChainCode chain;
+    if (!readChainCodeText(textFile, chain)) {
+        return false;
+    }
+
+    ChainCodeWriter writer(binaryFile);
+    return writer.isOpen() && writer.write(chain);
+}
+
+void reconstructFromFile(const string &chainCodeFile, const string &backgroundFile) {
+    Mat img = imread(backgroundFile, IMREAD_GRAYSCALE);
+    if (img.empty()) {
+        cerr << "Could not read the background image: " << backgroundFile << endl;
+        return;
+    }
+
+    vector<ChainCode> chains;
+    if (chainCodeFile.ends_with(".fcc")) {
+        ChainCodeReader reader(chainCodeFile);
+        if (!reader.isOpen()) {
+            cerr << "Could not open chain code file: " << chainCodeFile << endl;
+            return;
+        }
+        ChainCode chain;
+        while (reader.next(chain)) {
+            chains.push_back(chain);
+        }
+    } else {
+        ChainCode chain;
+        if (!readChainCodeText(chainCodeFile, chain)) {
+            return;
+        }
+        chains.push_back(chain);
+    }
 
-    reconstructBorder(img, startPoint, chainCode);
+    for (const ChainCode &chain : chains) {
+        cout << "Starting point: (" << chain.start.x << ", " << chain.start.y << ")" << endl;
+        cout << "Chain code length: " << chain.codes.size() << endl;
+
+        reconstructBorder(img, chain.start, chain.codes);
+    }
 
     imshow("Reconstructed Border", img);
     waitKey(0);
@@ -175,6 +228,59 @@ void extractBorder() {
     cout << endl;
 }
 
+void extractAllBorders() {
+    const Mat img = imread("../images/triangle_up.bmp", IMREAD_GRAYSCALE);
+    if (img.empty()) {
+        cerr << "Could not read the image." << endl;
+        return;
+    }
+
+    const vector<Contour> contours = ContourTracer::traceAll(img);
+
+    Mat borderImg(img.size(), CV_8UC1, Scalar(255));
+    for (size_t i = 0; i < contours.size(); ++i) {
+        const Contour &contour = contours[i];
+        reconstructBorder(borderImg, contour.chain.start, contour.chain.codes);
+
+        cout << "Contour " << i << (contour.hole ? " (hole)" : " (outer)")
+             << " start: " << contour.chain.start
+             << " length: " << contour.chain.codes.size()
+             << " parent: " << contour.parent << endl;
+
+        const ShapeDescriptors shape = ChainDescriptors::compute(contour.chain);
+        cout << "  area: " << shape.area << " perimeter: " << shape.perimeter
+             << " bbox: " << shape.boundingBox << " centroid: " << shape.centroid
+             << " elongation: " << shape.elongation * 180 / CV_PI << endl;
+    }
+
+    imshow("All Borders", borderImg);
+    waitKey(0);
+
+    vector<ChainCode> chains;
+    for (const Contour &contour : contours) {
+        chains.push_back(contour.chain);
+    }
+    const string archivePath = (filesystem::temp_directory_path() / "borders.fcr").string();
+    if (ChainCodec::write(archivePath, chains)) {
+        const ChainCodecReader archive(archivePath);
+        ChainCode last;
+        if (archive.isOpen() && archive.size() > 0 && archive.decode(archive.size() - 1, last)) {
+            cout << "Compressed " << archive.size() << " contours, last one has "
+                 << last.codes.size() << " codes" << endl;
+        }
+    }
+    error_code ignored;
+    filesystem::remove(archivePath, ignored);
+
+    const Mat filled = ChainRasterizer::mask(contours, img.size());
+    const Mat labels = ChainRasterizer::labels(contours, img.size());
+    double numLabels;
+    minMaxLoc(labels, nullptr, &numLabels);
+    cout << "Filled " << contours.size() << " contours into " << numLabels << " regions" << endl;
+
+    imshow("Filled", filled);
+    waitKey(0);
+}
 
 Point findStartingPoint(const Mat &img) {
     for (int y = 0; y < img.rows; ++y) {
@@ -0,0 +1,88 @@
+#include "BitImage.h"
+
+#include <bit>
+#include <cstring>
+
+// Rows are converted a byte (eight pixels) at a time, which relies on byte
+// k of a word holding pixels 8k .. 8k + 7.
+static_assert(std::endian::native == std::endian::little);
+
+namespace {
+    constexpr uint64_t lowBits = 0x7F7F7F7F7F7F7F7Full;
+    constexpr uint64_t highBits = 0x8080808080808080ull;
+
+    // One bit per byte of eight pixels: bit k is set when byte k is zero.
+    uint8_t packBlack(const uchar* pixels) {
+        uint64_t bytes;
+        std::memcpy(&bytes, pixels, 8);
+        const uint64_t zero = ~(((bytes & lowBits) + lowBits) | bytes | lowBits);
+        return static_cast<uint8_t>((zero >> 7) * 0x0102040810204080ull >> 56);
+    }
+
+    // The inverse: byte k is 0 when bit k is set and 255 otherwise.
+    void unpackBlack(const uint8_t bits, uchar* pixels) {
+        const uint64_t spread = bits * 0x0101010101010101ull & 0x8040201008040201ull;
+        const uint64_t set = (((spread & lowBits) + lowBits) | spread) & highBits;
+        const uint64_t bytes = ~((set >> 7) * 0xFF);
+        std::memcpy(pixels, &bytes, 8);
+    }
+}
+
+BitImage::BitImage(const int rows, const int cols)
+    : rows(rows), cols(cols), stride((cols + 63) / 64), words(static_cast<size_t>(rows) * stride, 0) {}
+
+BitImage BitImage::fromMat(const cv::Mat& src) {
+    CV_Assert(src.type() == CV_8UC1);
+
+    BitImage image(src.rows, src.cols);
+    for (int r = 0; r < src.rows; r++) {
+        packRow(src.ptr<uchar>(r), src.cols, image.row(r));
+    }
+    return image;
+}
+
+cv::Mat BitImage::toMat() const {
+    cv::Mat dst(rows, cols, CV_8UC1);
+    for (int r = 0; r < rows; r++) {
+        unpackRow(row(r), cols, dst.ptr<uchar>(r));
+    }
+    return dst;
+}
+
+void BitImage::packRow(const uchar* in, const int cols, uint64_t* out) {
+    auto* bytes = reinterpret_cast<uint8_t*>(out);
+    const int fullBytes = cols / 8;
+    for (int b = 0; b < fullBytes; b++) {
+        bytes[b] = packBlack(in + 8 * b);
+    }
+    for (int c = 8 * fullBytes; c < cols; c++) {
+        bytes[c / 8] |= static_cast<uint8_t>((in[c] == 0) << (c % 8));
+    }
+}
+
+void BitImage::unpackRow(const uint64_t* in, const int cols, uchar* out) {
+    const auto* bytes = reinterpret_cast<const uint8_t*>(in);
+    const int fullBytes = cols / 8;
+    for (int b = 0; b < fullBytes; b++) {
+        unpackBlack(bytes[b], out + 8 * b);
+    }
+    for (int c = 8 * fullBytes; c < cols; c++) {
+        out[c] = bytes[c / 8] >> (c % 8) & 1 ? 0 : 255;
+    }
+}
+
+BitImage BitImage::inverted() const {
+    BitImage result(rows, cols);
+    const uint64_t last = lastMask();
+    for (int r = 0; r < rows; r++) {
+        const uint64_t* in = row(r);
+        uint64_t* out = result.row(r);
+        for (int w = 0; w < stride; w++) {
+            out[w] = ~in[w];
+        }
+        if (stride > 0) {
+            out[stride - 1] &= last;
+        }
+    }
+    return result;
+}
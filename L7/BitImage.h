@@ -0,0 +1,48 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// Binary image packed 64 pixels per word: pixel x of a row is bit x % 64 of
+// word x / 64. Set bits are object pixels, which are black (0) in the Mat
+// convention; bits past the last column are always clear.
+struct BitImage {
+    int rows = 0;
+    int cols = 0;
+    int stride = 0;
+    std::vector<uint64_t> words;
+
+    BitImage() = default;
+    BitImage(int rows, int cols);
+
+    static BitImage fromMat(const cv::Mat& src);
+    [[nodiscard]] cv::Mat toMat() const;
+
+    // Single-row conversions behind fromMat and toMat, for code that streams
+    // rows instead of holding a whole image. out must start out clear.
+    static void packRow(const uchar* in, int cols, uint64_t* out);
+    static void unpackRow(const uint64_t* in, int cols, uchar* out);
+
+    uint64_t* row(const int r) { return words.data() + static_cast<size_t>(r) * stride; }
+    [[nodiscard]] const uint64_t* row(const int r) const { return words.data() + static_cast<size_t>(r) * stride; }
+
+    // Word w of a row shifted by one pixel: bit x of west holds pixel x - 1
+    // and bit x of east holds pixel x + 1, reading 0 outside the row.
+    static uint64_t west(const uint64_t* row, const int w) {
+        return row[w] << 1 | (w > 0 ? row[w - 1] >> 63 : 0);
+    }
+    static uint64_t east(const uint64_t* row, const int w, const int stride) {
+        return row[w] >> 1 | (w + 1 < stride ? row[w + 1] << 63 : 0);
+    }
+
+    // Bits of the last word in each row that belong to the image.
+    [[nodiscard]] uint64_t lastMask() const { return cols % 64 == 0 ? ~0ull : (1ull << cols % 64) - 1; }
+
+    [[nodiscard]] bool get(const int r, const int c) const { return row(r)[c / 64] >> (c % 64) & 1; }
+    void set(const int r, const int c) { row(r)[c / 64] |= 1ull << (c % 64); }
+
+    [[nodiscard]] BitImage inverted() const;
+
+    bool operator==(const BitImage& other) const = default;
+};
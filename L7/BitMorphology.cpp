@@ -0,0 +1,327 @@
+#include "BitMorphology.h"
+
+#include <algorithm>
+
+void BitMorphology::dilateRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out,
+                              const int stride, const uint64_t last) {
+    for (int w = 0; w < stride; w++) {
+        uint64_t word = row[w] | BitImage::west(row, w) | BitImage::east(row, w, stride);
+        if (above != nullptr) {
+            word |= above[w];
+        }
+        if (below != nullptr) {
+            word |= below[w];
+        }
+        out[w] = word;
+    }
+    if (stride > 0) {
+        out[stride - 1] &= last;
+    }
+}
+
+void BitMorphology::erodeRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out,
+                             const int stride) {
+    // Rows on the image border always erode: their outside neighbour is
+    // background.
+    if (above == nullptr || below == nullptr) {
+        std::fill_n(out, stride, 0);
+        return;
+    }
+    for (int w = 0; w < stride; w++) {
+        out[w] = row[w] & BitImage::west(row, w) & BitImage::east(row, w, stride) & above[w] & below[w];
+    }
+}
+
+BitImage BitMorphology::dilate(const BitImage& src) {
+    BitImage result(src.rows, src.cols);
+    for (int r = 0; r < src.rows; r++) {
+        dilateRow(r > 0 ? src.row(r - 1) : nullptr, src.row(r), r < src.rows - 1 ? src.row(r + 1) : nullptr,
+                  result.row(r), src.stride, src.lastMask());
+    }
+    return result;
+}
+
+BitImage BitMorphology::erode(const BitImage& src) {
+    BitImage result(src.rows, src.cols);
+    for (int r = 1; r < src.rows - 1; r++) {
+        erodeRow(src.row(r - 1), src.row(r), src.row(r + 1), result.row(r), src.stride);
+    }
+    return result;
+}
+
+BitImage BitMorphology::boundary(const BitImage& src) {
+    BitImage result = erode(src);
+    for (size_t i = 0; i < result.words.size(); i++) {
+        result.words[i] = src.words[i] & ~result.words[i];
+    }
+    return result;
+}
+
+BitImage BitMorphology::conditionalDilate(const BitImage& src, const BitImage& mask) {
+    BitImage result = dilate(src);
+    for (size_t i = 0; i < result.words.size(); i++) {
+        result.words[i] &= mask.words[i];
+    }
+    return result;
+}
+
+uint64_t BitMorphology::bitsAt(const uint64_t* row, const int stride, const int begin) {
+    const int q = begin >= 0 ? begin / 64 : -((63 - begin) / 64);
+    const int s = begin - 64 * q;
+    const uint64_t low = q >= 0 && q < stride ? row[q] : 0;
+    if (s == 0) {
+        return low;
+    }
+    const uint64_t high = q + 1 >= 0 && q + 1 < stride ? row[q + 1] : 0;
+    return low >> s | high << (64 - s);
+}
+
+BitImage BitMorphology::rowSpans(const BitImage& src, const int length, const bool erode) {
+    const int margin = spanMargin(length);
+    BitImage result(src.rows, src.cols + 2 * margin);
+    const int stride = result.stride;
+    const int words = length / 64;
+    std::vector<uint64_t> span(stride);
+    std::vector<uint64_t> next(stride);
+    std::vector<uint64_t> prefix(words > 0 ? stride + words : 0);
+    std::vector<uint64_t> suffix(prefix.size());
+
+    for (int r = 0; r < src.rows; r++) {
+        // After each doubling step, bit x of span covers x .. x + covered - 1.
+        // Doubling stops at 64, so this is at most six steps.
+        for (int w = 0; w < stride; w++) {
+            span[w] = bitsAt(src.row(r), src.stride, 64 * w - margin);
+        }
+        int covered = 1;
+        while (2 * covered <= std::min(length, 64)) {
+            for (int w = 0; w < stride; w++) {
+                const uint64_t shifted = bitsAt(span.data(), stride, 64 * w + covered);
+                next[w] = erode ? span[w] & shifted : span[w] | shifted;
+            }
+            span.swap(next);
+            covered *= 2;
+        }
+
+        uint64_t* out = result.row(r);
+        if (words == 0) {
+            for (int w = 0; w < stride; w++) {
+                const uint64_t tail = bitsAt(span.data(), stride, 64 * w + length - covered);
+                out[w] = erode ? span[w] & tail : span[w] | tail;
+            }
+            continue;
+        }
+
+        // Bit x of span word w + k covers x + 64k .. x + 64k + 63, so words
+        // w .. w + words - 1 cover all but the last length % 64 pixels of the
+        // window. That word window comes from van Herk / Gil-Werman block
+        // prefix and suffix scans over the words, and one read of span at
+        // length - 64 covers the tail.
+        std::copy(span.begin(), span.end(), prefix.begin());
+        std::fill(prefix.begin() + stride, prefix.end(), 0);
+        const int n = static_cast<int>(prefix.size());
+        for (int begin = 0; begin < n; begin += words) {
+            const int end = std::min(begin + words, n);
+            suffix[end - 1] = prefix[end - 1];
+            for (int i = end - 2; i >= begin; i--) {
+                suffix[i] = erode ? suffix[i + 1] & prefix[i] : suffix[i + 1] | prefix[i];
+            }
+            for (int i = begin + 1; i < end; i++) {
+                prefix[i] = erode ? prefix[i - 1] & prefix[i] : prefix[i - 1] | prefix[i];
+            }
+        }
+        for (int w = 0; w < stride; w++) {
+            const uint64_t tail = bitsAt(span.data(), stride, 64 * w + length - 64);
+            out[w] = erode ? suffix[w] & prefix[w + words - 1] & tail : suffix[w] | prefix[w + words - 1] | tail;
+        }
+    }
+
+    return result;
+}
+
+BitImage BitMorphology::rowWindow(const BitImage& src, const int length, const int lo, const bool erode) {
+    const BitImage spans = rowSpans(src, length, erode);
+    const int margin = spanMargin(length);
+    BitImage result(src.rows, src.cols);
+    accumulate(result, spans, 0, lo + margin, false);
+    return result;
+}
+
+BitImage BitMorphology::columnWindow(const BitImage& src, const int length, const int lo, const bool erode) {
+    // Rows are padded with length empty rows on both sides and cut into
+    // blocks of length rows. A window then spans at most two blocks: the
+    // suffix of the first and the prefix of the second.
+    const int stride = src.stride;
+    const int padded = src.rows + 2 * length;
+    const auto padRow = [&](const int i) -> const uint64_t* {
+        const int r = i - length;
+        return r >= 0 && r < src.rows ? src.row(r) : nullptr;
+    };
+
+    std::vector<uint64_t> prefix(static_cast<size_t>(padded) * stride);
+    std::vector<uint64_t> suffix(static_cast<size_t>(padded) * stride);
+    for (int i = 0; i < padded; i++) {
+        const uint64_t* in = padRow(i);
+        uint64_t* out = prefix.data() + static_cast<size_t>(i) * stride;
+        const bool restart = i % length == 0;
+        for (int w = 0; w < stride; w++) {
+            const uint64_t value = in != nullptr ? in[w] : 0;
+            out[w] = restart ? value : erode ? out[w - stride] & value : out[w - stride] | value;
+        }
+    }
+    for (int i = padded - 1; i >= 0; i--) {
+        const uint64_t* in = padRow(i);
+        uint64_t* out = suffix.data() + static_cast<size_t>(i) * stride;
+        const bool restart = i % length == length - 1 || i == padded - 1;
+        for (int w = 0; w < stride; w++) {
+            const uint64_t value = in != nullptr ? in[w] : 0;
+            out[w] = restart ? value : erode ? out[w + stride] & value : out[w + stride] | value;
+        }
+    }
+
+    BitImage result(src.rows, src.cols);
+    for (int r = 0; r < src.rows; r++) {
+        const int first = r + lo + length;
+        const uint64_t* head = suffix.data() + static_cast<size_t>(first) * stride;
+        const uint64_t* tail = prefix.data() + static_cast<size_t>(first + length - 1) * stride;
+        uint64_t* out = result.row(r);
+        for (int w = 0; w < stride; w++) {
+            out[w] = erode ? head[w] & tail[w] : head[w] | tail[w];
+        }
+    }
+
+    return result;
+}
+
+void BitMorphology::accumulate(BitImage& dst, const BitImage& src, const int dy, const int dx, const bool erode) {
+    const uint64_t last = dst.lastMask();
+    for (int r = 0; r < dst.rows; r++) {
+        uint64_t* out = dst.row(r);
+        const int sr = r + dy;
+        if (sr < 0 || sr >= src.rows) {
+            if (erode) {
+                std::fill_n(out, dst.stride, 0);
+            }
+            continue;
+        }
+
+        const uint64_t* in = src.row(sr);
+        for (int w = 0; w < dst.stride; w++) {
+            const uint64_t value = bitsAt(in, src.stride, 64 * w + dx);
+            out[w] = erode ? out[w] & value : out[w] | value;
+        }
+        if (dst.stride > 0) {
+            out[dst.stride - 1] &= last;
+        }
+    }
+}
+
+BitImage BitMorphology::shear(const BitImage& src, const bool downRight) {
+    BitImage result(src.rows, src.cols + src.rows - 1);
+    for (int r = 0; r < src.rows; r++) {
+        const int offset = downRight ? src.rows - 1 - r : r;
+        const uint64_t* in = src.row(r);
+        uint64_t* out = result.row(r);
+        for (int w = 0; w < result.stride; w++) {
+            out[w] = bitsAt(in, src.stride, 64 * w - offset);
+        }
+    }
+    return result;
+}
+
+BitImage BitMorphology::unshear(const BitImage& sheared, const int cols, const bool downRight) {
+    BitImage result(sheared.rows, cols);
+    const uint64_t last = result.lastMask();
+    for (int r = 0; r < sheared.rows; r++) {
+        const int offset = downRight ? sheared.rows - 1 - r : r;
+        const uint64_t* in = sheared.row(r);
+        uint64_t* out = result.row(r);
+        for (int w = 0; w < result.stride; w++) {
+            out[w] = bitsAt(in, sheared.stride, 64 * w + offset);
+        }
+        if (result.stride > 0) {
+            out[result.stride - 1] &= last;
+        }
+    }
+    return result;
+}
+
+BitImage BitMorphology::apply(const BitImage& src, const StructuringElement& element, const bool erode) {
+    const std::vector<ElementRun> runs = element.runs();
+    CV_Assert(!runs.empty());
+
+    // Erosion combines src(p + b) over the element, dilation src(p - b), so
+    // a run covering offsets lo .. hi is a window from lo, or from -hi.
+    const auto from = [erode](const int lo, const int hi) { return erode ? lo : -hi; };
+    const int dyMin = runs.front().dy;
+    const int dyMax = runs.back().dy;
+    const int height = dyMax - dyMin + 1;
+
+    if (element.shape == StructuringElement::Shape::Rectangle) {
+        const ElementRun& run = runs.front();
+        const BitImage rows = rowWindow(src, run.x1 - run.x0 + 1, from(run.x0, run.x1), erode);
+        return columnWindow(rows, height, from(dyMin, dyMax), erode);
+    }
+
+    if (element.shape == StructuringElement::Shape::Line) {
+        if (element.angle == 0) {
+            return rowWindow(src, runs.front().x1 - runs.front().x0 + 1, from(runs.front().x0, runs.front().x1), erode);
+        }
+        if (element.angle == 90) {
+            return columnWindow(src, height, from(dyMin, dyMax), erode);
+        }
+        // Along a 135 degree line x grows with y (down-right); shearing by
+        // rows - 1 - r puts such a line in one column.
+        const bool downRight = element.angle == 135;
+        const BitImage columns = columnWindow(shear(src, downRight), height, from(dyMin, dyMax), erode);
+        return unshear(columns, src.cols, downRight);
+    }
+
+    // Discs and masks: one row window per distinct run length, shifted into
+    // place for every run of that length.
+    BitImage result(src.rows, src.cols);
+    if (erode) {
+        const uint64_t last = result.lastMask();
+        for (int r = 0; r < result.rows; r++) {
+            uint64_t* out = result.row(r);
+            std::fill_n(out, result.stride, ~0ull);
+            if (result.stride > 0) {
+                out[result.stride - 1] &= last;
+            }
+        }
+    }
+
+    std::vector<ElementRun> byLength = runs;
+    std::ranges::sort(byLength, {}, [](const ElementRun& run) { return run.x1 - run.x0; });
+    BitImage spans;
+    int spansLength = 0;
+    for (const ElementRun& run : byLength) {
+        const int length = run.x1 - run.x0 + 1;
+        if (length != spansLength) {
+            spans = rowSpans(src, length, erode);
+            spansLength = length;
+        }
+        const int margin = spanMargin(length);
+        if (erode) {
+            accumulate(result, spans, run.dy, run.x0 + margin, true);
+        } else {
+            accumulate(result, spans, -run.dy, margin - run.x1, false);
+        }
+    }
+    return result;
+}
+
+BitImage BitMorphology::erode(const BitImage& src, const StructuringElement& element) {
+    return apply(src, element, true);
+}
+
+BitImage BitMorphology::dilate(const BitImage& src, const StructuringElement& element) {
+    return apply(src, element, false);
+}
+
+BitImage BitMorphology::opening(const BitImage& src, const StructuringElement& element) {
+    return dilate(erode(src, element), element);
+}
+
+BitImage BitMorphology::closing(const BitImage& src, const StructuringElement& element) {
+    return erode(dilate(src, element), element);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "BitImage.h"
+#include "StructuringElement.h"
+
+// Morphology with the 4-neighbour cross (centre included) on packed images.
+// Each word combines its horizontal neighbours by shifting in the edge bits
+// of the adjacent words, and its vertical neighbours by reading the rows
+// above and below, so 64 pixels are handled per operation. Pixels outside
+// the image count as background.
+class BitMorphology {
+public:
+    static BitImage dilate(const BitImage& src);
+    static BitImage erode(const BitImage& src);
+
+    // Object pixels that do not survive erosion.
+    static BitImage boundary(const BitImage& src);
+
+    // One output row of dilate and erode from the input rows around it;
+    // above and below are nullptr outside the image and out must not alias
+    // the inputs.
+    static void dilateRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out,
+                          int stride, uint64_t last);
+    static void erodeRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* out,
+                         int stride);
+
+    // dilate(src) restricted to the object pixels of mask.
+    static BitImage conditionalDilate(const BitImage& src, const BitImage& mask);
+
+    // Morphology with any structuring element. Rectangles split into a row
+    // and a column window. Row windows build 64-pixel spans in at most six
+    // doubling steps, then combine whole words of spans with the van Herk /
+    // Gil-Werman block prefix and suffix scans; column windows use the same
+    // scans on 64-pixel words down the columns. Both cost O(1) per word
+    // whatever the size. Diagonal lines are sheared into
+    // columns first. Discs and masks are decomposed into their horizontal
+    // runs, each a row window shifted into place.
+    static BitImage erode(const BitImage& src, const StructuringElement& element);
+    static BitImage dilate(const BitImage& src, const StructuringElement& element);
+    static BitImage opening(const BitImage& src, const StructuringElement& element);
+    static BitImage closing(const BitImage& src, const StructuringElement& element);
+
+private:
+    // Bits begin .. begin + 63 of a row, reading 0 outside it.
+    static uint64_t bitsAt(const uint64_t* row, int stride, int begin);
+
+    // Windows of length pixels along each row, combined with AND when
+    // erode and OR otherwise: bit x + spanMargin(length) of the result covers
+    // pixels x .. x + length - 1, for every window that overlaps the image.
+    static BitImage rowSpans(const BitImage& src, int length, bool erode);
+    static int spanMargin(const int length) { return (length + 63) / 64 * 64; }
+
+    // Each pixel x combines the pixels x + lo .. x + lo + length - 1 of its
+    // row or column.
+    static BitImage rowWindow(const BitImage& src, int length, int lo, bool erode);
+    static BitImage columnWindow(const BitImage& src, int length, int lo, bool erode);
+
+    // dst(r, x) combines src(r + dy, x + dx).
+    static void accumulate(BitImage& dst, const BitImage& src, int dy, int dx, bool erode);
+
+    // Shifts row r by r bits (or rows - 1 - r for the other diagonal) so
+    // that one diagonal direction becomes a column, and back.
+    static BitImage shear(const BitImage& src, bool downRight);
+    static BitImage unshear(const BitImage& sheared, int cols, bool downRight);
+
+    static BitImage apply(const BitImage& src, const StructuringElement& element, bool erode);
+};
@@ -0,0 +1,126 @@
+#include "DistanceTransform.h"
+
+#include <algorithm>
+#include <climits>
+#include "BitMorphology.h"
+
+template<Metric M>
+void DistanceTransform::transform(const BitImage& src, const bool toObject, std::vector<int>& d) {
+    // The buffer has a one pixel frame: 0 when the outside is background
+    // and we measure to it, "infinity" otherwise.
+    const int rows = src.rows;
+    const int cols = src.cols;
+    const int width = cols + 2;
+    constexpr int infinity = INT_MAX - 1;
+
+    d.assign(static_cast<size_t>(rows + 2) * width, toObject ? infinity : 0);
+    const uint64_t flip = toObject ? 0 : ~0ull;
+    for (int r = 0; r < rows; r++) {
+        const uint64_t* bits = src.row(r);
+        int* row = d.data() + static_cast<size_t>(r + 1) * width + 1;
+        for (int c = 0; c < cols; c++) {
+            row[c] = (bits[c / 64] ^ flip) >> (c % 64) & 1 ? 0 : infinity;
+        }
+    }
+
+    for (int r = 1; r <= rows; r++) {
+        int* row = d.data() + static_cast<size_t>(r) * width;
+        const int* above = row - width;
+        for (int c = 1; c <= cols; c++) {
+            int best = std::min(above[c], row[c - 1]);
+            if constexpr (M == Metric::Chessboard) {
+                best = std::min({best, above[c - 1], above[c + 1]});
+            }
+            row[c] = std::min(row[c], best + 1);
+        }
+    }
+
+    for (int r = rows; r >= 1; r--) {
+        int* row = d.data() + static_cast<size_t>(r) * width;
+        const int* below = row + width;
+        for (int c = cols; c >= 1; c--) {
+            int best = std::min(below[c], row[c + 1]);
+            if constexpr (M == Metric::Chessboard) {
+                best = std::min({best, below[c - 1], below[c + 1]});
+            }
+            row[c] = std::min(row[c], best + 1);
+        }
+    }
+}
+
+void DistanceTransform::transform(const BitImage& src, const Metric metric, const bool toObject, std::vector<int>& d) {
+    if (metric == Metric::CityBlock) {
+        transform<Metric::CityBlock>(src, toObject, d);
+    } else {
+        transform<Metric::Chessboard>(src, toObject, d);
+    }
+}
+
+cv::Mat DistanceTransform::toMat(const std::vector<int>& d, const int rows, const int cols) {
+    cv::Mat distance(rows, cols, CV_32SC1);
+    for (int r = 0; r < rows; r++) {
+        std::copy_n(d.data() + static_cast<size_t>(r + 1) * (cols + 2) + 1, cols, distance.ptr<int>(r));
+    }
+    return distance;
+}
+
+BitImage DistanceTransform::threshold(const std::vector<int>& d, const int rows, const int cols, const int n,
+                                      const bool above) {
+    BitImage result(rows, cols);
+    for (int r = 0; r < rows; r++) {
+        const int* row = d.data() + static_cast<size_t>(r + 1) * (cols + 2) + 1;
+        uint64_t* bits = result.row(r);
+        for (int c = 0; c < cols; c++) {
+            bits[c / 64] |= static_cast<uint64_t>((row[c] > n) == above) << (c % 64);
+        }
+    }
+    return result;
+}
+
+cv::Mat DistanceTransform::toBackground(const BitImage& src, const Metric metric) {
+    std::vector<int> d;
+    transform(src, metric, false, d);
+    return toMat(d, src.rows, src.cols);
+}
+
+cv::Mat DistanceTransform::toObject(const BitImage& src, const Metric metric) {
+    std::vector<int> d;
+    transform(src, metric, true, d);
+    return toMat(d, src.rows, src.cols);
+}
+
+BitImage DistanceTransform::erode(const BitImage& src, const int n, const Metric metric, const Method method) {
+    if (method == Method::Auto && metric == Metric::CityBlock && n < iterateLimit) {
+        BitImage result = src;
+        for (int i = 0; i < n; i++) {
+            result = BitMorphology::erode(result);
+        }
+        return result;
+    }
+
+    std::vector<int> d;
+    transform(src, metric, false, d);
+    return threshold(d, src.rows, src.cols, n, true);
+}
+
+BitImage DistanceTransform::dilate(const BitImage& src, const int n, const Metric metric, const Method method) {
+    if (method == Method::Auto && metric == Metric::CityBlock && n < iterateLimit) {
+        BitImage result = src;
+        for (int i = 0; i < n; i++) {
+            result = BitMorphology::dilate(result);
+        }
+        return result;
+    }
+
+    std::vector<int> d;
+    transform(src, metric, true, d);
+    return threshold(d, src.rows, src.cols, n, false);
+}
+
+BitImage DistanceTransform::opening(const BitImage& src, const int n, const Metric metric, const Method method) {
+    return dilate(erode(src, n, metric, method), n, metric, method);
+}
+
+BitImage DistanceTransform::closing(const BitImage& src, const int n, const Metric metric, const Method method) {
+    return erode(dilate(src, n, metric, method), n, metric, method);
+}
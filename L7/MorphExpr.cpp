@@ -0,0 +1,143 @@
+#include "MorphExpr.h"
+
+#include <algorithm>
+#include "BitMorphology.h"
+
+MorphExpr MorphExpr::then(const Op op) const {
+    return MorphExpr(std::make_shared<const Node>(Node{op, node}));
+}
+
+MorphExpr MorphExpr::dilate() const {
+    return then(Op::Dilate);
+}
+
+MorphExpr MorphExpr::erode() const {
+    return then(Op::Erode);
+}
+
+MorphExpr MorphExpr::opening() const {
+    return erode().dilate();
+}
+
+MorphExpr MorphExpr::closing() const {
+    return dilate().erode();
+}
+
+MorphExpr MorphExpr::boundary() const {
+    return then(Op::Boundary);
+}
+
+MorphExpr MorphExpr::repeat(const unsigned n) const {
+    return MorphExpr(std::make_shared<const Node>(Node{Op::Repeat, node, n}));
+}
+
+void MorphExpr::flatten(const Node* node, std::vector<Op>& ops) {
+    if (node == nullptr) {
+        return;
+    }
+    if (node->op != Op::Repeat) {
+        flatten(node->input.get(), ops);
+        ops.push_back(node->op);
+        return;
+    }
+    for (unsigned i = 0; i < node->count; i++) {
+        flatten(node->input.get(), ops);
+    }
+}
+
+template<typename Load, typename Store>
+void MorphExpr::stream(const std::vector<Op>& ops, const int rows, const int cols, const Load& load,
+                       const Store& store) {
+    const int stages = static_cast<int>(ops.size());
+    const int stride = (cols + 63) / 64;
+    const uint64_t last = BitImage(0, cols).lastMask();
+    const int bands = std::max(1, std::min(rows, cv::getNumThreads() * 4));
+
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        // Level 0 holds source rows and level s the output of stage s; each
+        // keeps its last three rows, slot r % 3 for row r.
+        std::vector<uint64_t> rings(static_cast<size_t>(stages + 1) * 3 * stride);
+        std::vector<int> next(stages + 1), end(stages + 1);
+        const auto slot = [&](const int level, const int r) {
+            return rings.data() + (static_cast<size_t>(level) * 3 + r % 3) * stride;
+        };
+
+        for (int b = range.start; b < range.end; b++) {
+            const int rowBegin = rows * b / bands;
+            const int rowEnd = rows * (b + 1) / bands;
+            for (int level = 0; level <= stages; level++) {
+                next[level] = std::max(0, rowBegin - (stages - level));
+                end[level] = std::min(rows, rowEnd + (stages - level));
+            }
+
+            // Each pass moves every level on by at most one row, as soon as
+            // the rows below it are ready, so no level runs more than two
+            // rows ahead of the next and the rings never overwrite a row
+            // still in use.
+            for (bool progress = true; progress;) {
+                progress = false;
+                for (int level = 0; level <= stages; level++) {
+                    const int r = next[level];
+                    if (r == end[level]) {
+                        continue;
+                    }
+                    uint64_t* out = slot(level, r);
+                    if (level == 0) {
+                        std::fill_n(out, stride, 0);
+                        load(r, out);
+                    } else {
+                        if (next[level - 1] <= std::min(r + 1, rows - 1)) {
+                            continue;
+                        }
+                        const uint64_t* above = r > 0 ? slot(level - 1, r - 1) : nullptr;
+                        const uint64_t* row = slot(level - 1, r);
+                        const uint64_t* below = r < rows - 1 ? slot(level - 1, r + 1) : nullptr;
+                        switch (ops[level - 1]) {
+                            case Op::Dilate:
+                                BitMorphology::dilateRow(above, row, below, out, stride, last);
+                                break;
+                            case Op::Erode:
+                                BitMorphology::erodeRow(above, row, below, out, stride);
+                                break;
+                            default:
+                                BitMorphology::erodeRow(above, row, below, out, stride);
+                                for (int w = 0; w < stride; w++) {
+                                    out[w] = row[w] & ~out[w];
+                                }
+                                break;
+                        }
+                    }
+                    if (level == stages) {
+                        store(r, out);
+                    }
+                    next[level]++;
+                    progress = true;
+                }
+            }
+        }
+    }, bands);
+}
+
+BitImage MorphExpr::evaluate(const BitImage& src) const {
+    std::vector<Op> ops;
+    flatten(node.get(), ops);
+
+    BitImage result(src.rows, src.cols);
+    stream(ops, src.rows, src.cols,
+           [&](const int r, uint64_t* out) { std::copy_n(src.row(r), src.stride, out); },
+           [&](const int r, const uint64_t* in) { std::copy_n(in, result.stride, result.row(r)); });
+    return result;
+}
+
+cv::Mat MorphExpr::evaluate(const cv::Mat& src) const {
+    CV_Assert(src.type() == CV_8UC1);
+
+    std::vector<Op> ops;
+    flatten(node.get(), ops);
+
+    cv::Mat result(src.rows, src.cols, CV_8UC1);
+    stream(ops, src.rows, src.cols,
+           [&](const int r, uint64_t* out) { BitImage::packRow(src.ptr<uchar>(r), src.cols, out); },
+           [&](const int r, const uint64_t* in) { BitImage::unpackRow(in, src.cols, result.ptr<uchar>(r)); });
+    return result;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "BitImage.h"
+
+// A lazily built composition of the cross-shaped operators. Building an
+// expression only links graph nodes, so repeated bodies are shared rather
+// than copied. evaluate() flattens the graph into a chain of row kernels and
+// streams the image through it once: every stage keeps the three input rows
+// it needs in a ring buffer, so a Mat is read and written one time however
+// long the chain is. Row bands run in parallel, each starting early by one
+// row per stage. The result equals applying the operators one by one.
+class MorphExpr {
+public:
+    // The identity expression.
+    MorphExpr() = default;
+
+    [[nodiscard]] MorphExpr dilate() const;
+    [[nodiscard]] MorphExpr erode() const;
+    [[nodiscard]] MorphExpr opening() const;
+    [[nodiscard]] MorphExpr closing() const;
+    [[nodiscard]] MorphExpr boundary() const;
+
+    // This expression applied n times in a row.
+    [[nodiscard]] MorphExpr repeat(unsigned n) const;
+
+    [[nodiscard]] BitImage evaluate(const BitImage& src) const;
+    [[nodiscard]] cv::Mat evaluate(const cv::Mat& src) const;
+
+private:
+    enum class Op { Dilate, Erode, Boundary, Repeat };
+
+    struct Node {
+        Op op;
+        std::shared_ptr<const Node> input;
+        unsigned count = 1;
+    };
+
+    std::shared_ptr<const Node> node;
+
+    explicit MorphExpr(std::shared_ptr<const Node> node) : node(std::move(node)) {}
+    [[nodiscard]] MorphExpr then(Op op) const;
+
+    static void flatten(const Node* node, std::vector<Op>& ops);
+
+    // Runs ops over a rows x cols image; load(r, out) fills a clear row of
+    // the source and store(r, in) receives a finished row of the result.
+    template<typename Load, typename Store>
+    static void stream(const std::vector<Op>& ops, int rows, int cols, const Load& load, const Store& store);
+};
@@ -0,0 +1,83 @@
+#include "Reconstruction.h"
+
+namespace {
+    constexpr uchar outside = 0;
+    constexpr uchar open = 1;
+    constexpr uchar reached = 2;
+}
+
+BitImage Reconstruction::byDilation(const BitImage& marker, const BitImage& mask) {
+    CV_Assert(marker.rows == mask.rows && marker.cols == mask.cols);
+
+    // One state byte per pixel with a one pixel frame of outside pixels, so
+    // that neighbours never need bounds checks.
+    const int rows = mask.rows;
+    const int cols = mask.cols;
+    const int width = cols + 2;
+    std::vector<uchar> state(static_cast<size_t>(rows + 2) * width, outside);
+    for (int r = 0; r < rows; r++) {
+        uchar* s = state.data() + static_cast<size_t>(r + 1) * width + 1;
+        for (int c = 0; c < cols; c++) {
+            if (mask.get(r, c)) {
+                s[c] = marker.get(r, c) ? reached : open;
+            }
+        }
+    }
+
+    const int offsets[4] = {-width, -1, 1, width};
+
+    for (int r = 1; r <= rows; r++) {
+        uchar* s = state.data() + static_cast<size_t>(r) * width;
+        for (int c = 1; c <= cols; c++) {
+            if (s[c] == open && (s[c - 1] == reached || s[c - width] == reached)) {
+                s[c] = reached;
+            }
+        }
+    }
+
+    // The anti-raster sweep also queues the pixels that could still grow
+    // into a neighbour the sweeps missed.
+    std::vector<int> queue;
+    for (int r = rows; r >= 1; r--) {
+        uchar* s = state.data() + static_cast<size_t>(r) * width;
+        for (int c = cols; c >= 1; c--) {
+            if (s[c] == open && (s[c + 1] == reached || s[c + width] == reached)) {
+                s[c] = reached;
+            }
+            if (s[c] == reached && (s[c + 1] == open || s[c + width] == open)) {
+                queue.push_back(r * width + c);
+            }
+        }
+    }
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        const int p = queue[head];
+        for (const int offset : offsets) {
+            if (state[p + offset] == open) {
+                state[p + offset] = reached;
+                queue.push_back(p + offset);
+            }
+        }
+    }
+
+    BitImage result(rows, cols);
+    for (int r = 0; r < rows; r++) {
+        const uchar* s = state.data() + static_cast<size_t>(r + 1) * width + 1;
+        for (int c = 0; c < cols; c++) {
+            if (s[c] == reached) {
+                result.set(r, c);
+            }
+        }
+    }
+    return result;
+}
+
+BitImage Reconstruction::fillRegion(const BitImage& boundary, const std::vector<cv::Point>& seeds) {
+    BitImage marker(boundary.rows, boundary.cols);
+    for (const cv::Point& seed : seeds) {
+        if (seed.x >= 0 && seed.x < boundary.cols && seed.y >= 0 && seed.y < boundary.rows) {
+            marker.set(seed.y, seed.x);
+        }
+    }
+    return byDilation(marker, boundary.inverted());
+}
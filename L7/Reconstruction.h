@@ -0,0 +1,21 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "BitImage.h"
+
+// Binary morphological reconstruction with the hybrid algorithm of Vincent
+// (1993): a raster and an anti-raster sweep propagate the marker through
+// the mask, then a FIFO of pixels that can still grow is drained. Every
+// pixel is visited a bounded number of times, so the cost is linear in the
+// image size whatever the shape of the mask.
+class Reconstruction {
+public:
+    // Mask pixels 4-connected to a marker pixel through the mask, the limit
+    // of repeated BitMorphology::conditionalDilate. Marker pixels outside
+    // the mask are ignored.
+    static BitImage byDilation(const BitImage& marker, const BitImage& mask);
+
+    // Background pixels of boundary 4-connected to any of the seeds.
+    static BitImage fillRegion(const BitImage& boundary, const std::vector<cv::Point>& seeds);
+};
@@ -0,0 +1,83 @@
+#include "StructuringElement.h"
+
+StructuringElement StructuringElement::rectangle(const int width, const int height) {
+    CV_Assert(width > 0 && height > 0);
+    StructuringElement element;
+    element.shape = Shape::Rectangle;
+    element.mask = cv::Mat(height, width, CV_8UC1, cv::Scalar(1));
+    element.anchor = cv::Point(width / 2, height / 2);
+    return element;
+}
+
+StructuringElement StructuringElement::line(const int length, const int angle) {
+    CV_Assert(length > 0 && (angle == 0 || angle == 45 || angle == 90 || angle == 135));
+    const int across = angle == 90 ? 1 : length;
+    const int down = angle == 0 ? 1 : length;
+
+    StructuringElement element;
+    element.shape = Shape::Line;
+    element.angle = angle;
+    element.mask = cv::Mat(down, across, CV_8UC1, cv::Scalar(0));
+    for (int i = 0; i < length; i++) {
+        const int x = angle == 90 ? 0 : i;
+        const int y = angle == 0 ? 0 : angle == 45 ? length - 1 - i : i;
+        element.mask.at<uchar>(y, x) = 1;
+        // The middle pixel, which for even diagonals is not the mask centre.
+        if (i == length / 2) {
+            element.anchor = cv::Point(x, y);
+        }
+    }
+    return element;
+}
+
+StructuringElement StructuringElement::disc(const int radius) {
+    CV_Assert(radius >= 0);
+    const int size = 2 * radius + 1;
+
+    StructuringElement element;
+    element.shape = Shape::Disc;
+    element.mask = cv::Mat(size, size, CV_8UC1, cv::Scalar(0));
+    for (int dy = -radius; dy <= radius; dy++) {
+        for (int dx = -radius; dx <= radius; dx++) {
+            if (dx * dx + dy * dy <= radius * radius) {
+                element.mask.at<uchar>(dy + radius, dx + radius) = 1;
+            }
+        }
+    }
+    element.anchor = cv::Point(radius, radius);
+    return element;
+}
+
+StructuringElement StructuringElement::fromMask(const cv::Mat& mask, const cv::Point anchor) {
+    CV_Assert(mask.type() == CV_8UC1 && !mask.empty());
+    StructuringElement element;
+    element.shape = Shape::Mask;
+    element.mask = mask.clone();
+    element.anchor = anchor.x < 0 || anchor.y < 0 ? cv::Point(mask.cols / 2, mask.rows / 2) : anchor;
+    return element;
+}
+
+StructuringElement StructuringElement::cross() {
+    cv::Mat mask(3, 3, CV_8UC1, cv::Scalar(0));
+    mask.at<uchar>(0, 1) = mask.at<uchar>(1, 0) = mask.at<uchar>(1, 1) = mask.at<uchar>(1, 2) = mask.at<uchar>(2, 1) = 1;
+    return fromMask(mask);
+}
+
+std::vector<ElementRun> StructuringElement::runs() const {
+    std::vector<ElementRun> result;
+    for (int y = 0; y < mask.rows; y++) {
+        const uchar* row = mask.ptr<uchar>(y);
+        for (int x = 0; x < mask.cols;) {
+            if (row[x] == 0) {
+                x++;
+                continue;
+            }
+            const int begin = x;
+            while (x < mask.cols && row[x] != 0) {
+                x++;
+            }
+            result.push_back({y - anchor.y, begin - anchor.x, x - 1 - anchor.x});
+        }
+    }
+    return result;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+// Horizontal run of element pixels, relative to the anchor: row dy,
+// columns x0 .. x1.
+struct ElementRun {
+    int dy;
+    int x0;
+    int x1;
+};
+
+// Structuring element as a CV_8U mask (non-zero pixels are members) with an
+// anchor. The shape tells BitMorphology which decomposition it may use.
+struct StructuringElement {
+    enum class Shape { Rectangle, Line, Disc, Mask };
+
+    Shape shape = Shape::Mask;
+    cv::Mat mask;
+    cv::Point anchor;
+    // Line direction in degrees, counter-clockwise from east on screen:
+    // 0, 45, 90 or 135.
+    int angle = 0;
+
+    static StructuringElement rectangle(int width, int height);
+    static StructuringElement line(int length, int angle);
+    static StructuringElement disc(int radius);
+    // The anchor defaults to the centre of the mask.
+    static StructuringElement fromMask(const cv::Mat& mask, cv::Point anchor = cv::Point(-1, -1));
+
+    // The 4-neighbour cross used by the rest of L7.
+    static StructuringElement cross();
+
+    [[nodiscard]] std::vector<ElementRun> runs() const;
+};
@@ -0,0 +1,118 @@
+#include "Thinning.h"
+
+#include <algorithm>
+#include <atomic>
+
+uint64_t Thinning::deletable(const uint64_t* above, const uint64_t* row, const uint64_t* below, const int w,
+                             const int stride, const bool first) {
+    if (row[w] == 0) {
+        return 0;
+    }
+
+    // P2 .. P9 clockwise from north.
+    const uint64_t p[8] = {
+        above != nullptr ? above[w] : 0,
+        above != nullptr ? BitImage::east(above, w, stride) : 0,
+        BitImage::east(row, w, stride),
+        below != nullptr ? BitImage::east(below, w, stride) : 0,
+        below != nullptr ? below[w] : 0,
+        below != nullptr ? BitImage::west(below, w) : 0,
+        BitImage::west(row, w),
+        above != nullptr ? BitImage::west(above, w) : 0,
+    };
+
+    // 2 <= B(P) <= 6 means at least two neighbours set and at least two
+    // clear; A(P) == 1 means exactly one 0 -> 1 transition around the ring.
+    uint64_t set1 = 0, set2 = 0, clear1 = 0, clear2 = 0, rise1 = 0, rise2 = 0;
+    for (int i = 0; i < 8; i++) {
+        set2 |= set1 & p[i];
+        set1 |= p[i];
+        clear2 |= clear1 & ~p[i];
+        clear1 |= ~p[i];
+        const uint64_t rise = ~p[i] & p[(i + 1) % 8];
+        rise2 |= rise1 & rise;
+        rise1 |= rise;
+    }
+
+    const uint64_t n = p[0], e = p[2], s = p[4], wp = p[6];
+    const uint64_t side = first ? ~(n & e & s) & ~(e & s & wp) : ~(n & e & wp) & ~(n & s & wp);
+    return row[w] & set2 & clear2 & rise1 & ~rise2 & side;
+}
+
+BitImage Thinning::zhangSuen(const BitImage& src) {
+    BitImage image = src;
+    BitImage removed(src.rows, src.cols);
+    const int rows = src.rows;
+    const int stride = src.stride;
+    const int bands = std::max(1, std::min(rows, cv::getNumThreads() * 4));
+
+    // Words changed by the last two sub-iterations, and rows holding any.
+    // A pixel whose neighbourhood is unchanged since the previous
+    // sub-iteration of the same kind gets the same answer as then, so only
+    // words next to a change are tested again.
+    std::vector<uint8_t> changed(static_cast<size_t>(rows) * stride, 3);
+    std::vector<uint8_t> rowChanged(rows, 3);
+
+    for (int pass = 0, quiet = 0; quiet < 2; pass++) {
+        const bool first = pass % 2 == 0;
+        const uint8_t bit = first ? 1 : 2;
+
+        cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+            for (int b = range.start; b < range.end; b++) {
+                for (int r = rows * b / bands; r < rows * (b + 1) / bands; r++) {
+                    uint64_t* out = removed.row(r);
+                    const int top = std::max(r - 1, 0);
+                    const int bottom = std::min(r + 1, rows - 1);
+                    if (std::none_of(rowChanged.begin() + top, rowChanged.begin() + bottom + 1,
+                                     [](const uint8_t flags) { return flags != 0; })) {
+                        std::fill_n(out, stride, 0);
+                        continue;
+                    }
+
+                    const uint64_t* above = r > 0 ? image.row(r - 1) : nullptr;
+                    const uint64_t* row = image.row(r);
+                    const uint64_t* below = r < rows - 1 ? image.row(r + 1) : nullptr;
+                    for (int w = 0; w < stride; w++) {
+                        bool active = false;
+                        for (int y = top; y <= bottom && !active; y++) {
+                            const uint8_t* flags = changed.data() + static_cast<size_t>(y) * stride;
+                            active = flags[w] != 0 || (w > 0 && flags[w - 1] != 0) ||
+                                     (w + 1 < stride && flags[w + 1] != 0);
+                        }
+                        out[w] = active ? deletable(above, row, below, w, stride, first) : 0;
+                    }
+                }
+            }
+        }, bands);
+
+        // This pass's flag replaces the one left by the previous pass of the
+        // same kind.
+        std::atomic<bool> any = false;
+        cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+            for (int b = range.start; b < range.end; b++) {
+                for (int r = rows * b / bands; r < rows * (b + 1) / bands; r++) {
+                    uint64_t* row = image.row(r);
+                    const uint64_t* out = removed.row(r);
+                    uint8_t* flags = changed.data() + static_cast<size_t>(r) * stride;
+                    bool rowAny = false;
+                    for (int w = 0; w < stride; w++) {
+                        flags[w] &= ~bit;
+                        if (out[w] != 0) {
+                            row[w] &= ~out[w];
+                            flags[w] |= bit;
+                            rowAny = true;
+                        }
+                    }
+                    rowChanged[r] = static_cast<uint8_t>(rowAny ? rowChanged[r] | bit : rowChanged[r] & ~bit);
+                    if (rowAny) {
+                        any = true;
+                    }
+                }
+            }
+        }, bands);
+
+        quiet = any ? 0 : quiet + 1;
+    }
+
+    return image;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "BitImage.h"
+
+// Zhang-Suen thinning on packed images: object regions are peeled
+// alternately from the south-east and north-west until an 8-connected
+// skeleton one pixel wide remains. Pixels outside the image count as
+// background.
+class Thinning {
+public:
+    static BitImage zhangSuen(const BitImage& src);
+
+private:
+    // Object pixels of word w that one sub-iteration removes, with the
+    // Zhang-Suen neighbourhood test evaluated on the eight neighbour words
+    // at once: neighbour counts and 0 -> 1 transitions are kept bit-sliced,
+    // one bit per pixel.
+    static uint64_t deletable(const uint64_t* above, const uint64_t* row, const uint64_t* below, int w,
+                              int stride, bool first);
+};
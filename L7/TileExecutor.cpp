@@ -0,0 +1,82 @@
+#include "TileExecutor.h"
+
+#include <algorithm>
+#include "BitMorphology.h"
+
+TileExecutor::TileExecutor(const int tileRows, const int tileWords)
+    : tileRows(std::max(1, tileRows)), tileWords(std::max(1, tileWords)) {}
+
+BitImage TileExecutor::run(const BitImage& src, const std::vector<TileStage>& stages) const {
+    int haloRows = 0;
+    int haloCols = 0;
+    for (const TileStage& stage : stages) {
+        haloRows += stage.haloRows;
+        haloCols += stage.haloCols;
+    }
+    const int haloWords = (haloCols + 63) / 64;
+
+    BitImage result(src.rows, src.cols);
+    const int tilesDown = (src.rows + tileRows - 1) / tileRows;
+    const int tilesAcross = (src.stride + tileWords - 1) / tileWords;
+
+    cv::parallel_for_(cv::Range(0, tilesDown * tilesAcross), [&](const cv::Range& range) {
+        for (int t = range.start; t < range.end; t++) {
+            const int r0 = t / tilesAcross * tileRows;
+            const int r1 = std::min(r0 + tileRows, src.rows);
+            const int w0 = t % tilesAcross * tileWords;
+            const int w1 = std::min(w0 + tileWords, src.stride);
+
+            const int top = std::max(r0 - haloRows, 0);
+            const int bottom = std::min(r1 + haloRows, src.rows);
+            const int left = std::max(w0 - haloWords, 0);
+            const int right = std::min(w1 + haloWords, src.stride);
+
+            // The tile ends at the image's own last column when it reaches
+            // it, so its padding bits stay clear.
+            BitImage tile(bottom - top, std::min(64 * right, src.cols) - 64 * left);
+            for (int r = top; r < bottom; r++) {
+                std::copy(src.row(r) + left, src.row(r) + right, tile.row(r - top));
+            }
+
+            for (const TileStage& stage : stages) {
+                tile = stage.apply(tile);
+            }
+
+            for (int r = r0; r < r1; r++) {
+                const uint64_t* in = tile.row(r - top) + (w0 - left);
+                std::copy(in, in + (w1 - w0), result.row(r) + w0);
+            }
+        }
+    }, tilesDown * tilesAcross);
+
+    return result;
+}
+
+TileStage TileExecutor::dilate() {
+    return {[](const BitImage& tile) { return BitMorphology::dilate(tile); }, 1, 1};
+}
+
+TileStage TileExecutor::erode() {
+    return {[](const BitImage& tile) { return BitMorphology::erode(tile); }, 1, 1};
+}
+
+TileStage TileExecutor::boundary() {
+    return {[](const BitImage& tile) { return BitMorphology::boundary(tile); }, 1, 1};
+}
+
+TileStage TileExecutor::dilate(const StructuringElement& element) {
+    return withElement(element, false);
+}
+
+TileStage TileExecutor::erode(const StructuringElement& element) {
+    return withElement(element, true);
+}
+
+TileStage TileExecutor::withElement(const StructuringElement& element, const bool erode) {
+    const int haloRows = std::max(element.anchor.y, element.mask.rows - 1 - element.anchor.y);
+    const int haloCols = std::max(element.anchor.x, element.mask.cols - 1 - element.anchor.x);
+    if (erode) {
+        return {[element](const BitImage& tile) { return BitMorphology::erode(tile, element); }, haloRows, haloCols};
+    }
+    return {[element](const BitImage& tile) { return BitMorphology::dilate(tile, element); }, haloRows, haloCols};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "BitImage.h"
+#include "StructuringElement.h"
+
+// One step of a tiled pipeline: a packed operator and how far its result
+// at a pixel reaches into the input, in rows and columns.
+struct TileStage {
+    std::function<BitImage(const BitImage&)> apply;
+    int haloRows = 1;
+    int haloCols = 1;
+};
+
+// Runs a chain of stages tile by tile on parallel_for_. Each tile is cut
+// out with the halo the whole chain needs (the sum of the stage halos,
+// columns rounded up to whole words), run through every stage while it is
+// small enough to stay in cache, and only its centre is written back. Tiles
+// own disjoint words of the output, so there are no seams and no locking.
+class TileExecutor {
+public:
+    explicit TileExecutor(int tileRows = 256, int tileWords = 16);
+
+    [[nodiscard]] BitImage run(const BitImage& src, const std::vector<TileStage>& stages) const;
+
+    static TileStage dilate();
+    static TileStage erode();
+    static TileStage boundary();
+    static TileStage dilate(const StructuringElement& element);
+    static TileStage erode(const StructuringElement& element);
+
+private:
+    int tileRows;
+    int tileWords;
+
+    static TileStage withElement(const StructuringElement& element, bool erode);
+};
@@ -1,12 +1,16 @@
 #include <iostream>
 #include <opencv2/opencv.hpp>
+#include "BitImage.h"
+#include "BitMorphology.h"
+#include "DistanceTransform.h"
+#include "MorphExpr.h"
+#include "Reconstruction.h"
+#include "Thinning.h"
+#include "TileExecutor.h"
 
 using namespace std;
 using namespace cv;
 
-constexpr int dx[4] = {-1, 0, 1, 0};
-constexpr int dy[4] = {0, -1, 0, 1};
-
 Mat dilate(const Mat& src);
 void runDilate();
 Mat erosion(const Mat& src);
@@ -17,10 +21,12 @@ Mat closing(const Mat& src);
 void runClosing();
 Mat boundaryExtraction(const Mat& src);
 void runBoundaryExtraction();
-Mat regionFilling(const Mat& src);
+Mat regionFilling(const Mat& src, const vector<Point>& seeds = {});
 void runRegionFilling();
+Mat thinning(const Mat& src);
+void runThinning();
 
-Mat runNTimes(const Mat& src, unsigned int n, Mat (*func)(const Mat&));
+Mat runTiled(const Mat& src, const vector<TileStage>& stages);
 
 
 int main() {
@@ -30,9 +36,27 @@ int main() {
     runClosing();
     runBoundaryExtraction();
     runRegionFilling();
+    runThinning();
     return 0;
 }
 
+void runThinning() {
+    const Mat src = imread("../images/1_Dilate/wdg2ded1_bw.bmp", IMREAD_GRAYSCALE);
+    if (src.empty()) {
+        std::cerr << "Error: Could not open or find the image!" << std::endl;
+        return;
+    }
+
+    const Mat thinned = thinning(src);
+    imshow("Original", src);
+    imshow("Thinned", thinned);
+    while (waitKey(0) & 0xFF != 27) {}
+}
+
+Mat thinning(const Mat& src) {
+    return Thinning::zhangSuen(BitImage::fromMat(src)).toMat();
+}
+
 void runRegionFilling() {
     const Mat src = imread("../images/6_RegionFilling/reg1neg1_bw.bmp", IMREAD_GRAYSCALE);
     if (src.empty()) {
@@ -46,51 +70,11 @@ void runRegionFilling() {
     while (waitKey(0) & 0xFF != 27) {}
 }
 
-Mat regionFilling(const Mat& src) {
-    auto Xk = Mat(src.size(), src.type(), Scalar(255));
-    Mat Xk_prev;
-
-    auto src_complement = Mat(src.size(), src.type());
-    bitwise_not(src, src_complement);
-
-    const int centerX = src.cols / 2;
-    const int centerY = src.rows / 2;
-    Xk.at<uchar>(centerY, centerX) = 0;
-
-    do {
-        Xk_prev = Xk.clone();
-
-        auto dilated = Mat(src.size(), src.type(), Scalar(255));
-        for (int y = 0; y < src.rows; y++) {
-            for (int x = 0; x < src.cols; x++) {
-                if (Xk_prev.at<uchar>(y, x) == 0) {
-                    dilated.at<uchar>(y, x) = 0;
-
-                    for (int i = 0; i < 4; i++) {
-                        const int newX = x + dx[i];
-                        const int newY = y + dy[i];
-
-                        if (newX >= 0 && newX < src.cols && newY >= 0 && newY < src.rows) {
-                            dilated.at<uchar>(newY, newX) = 0;
-                        }
-                    }
-                }
-            }
-        }
-
-        Xk = Mat(src.size(), src.type(), Scalar(255));
-        for (int y = 0; y < src.rows; y++) {
-            for (int x = 0; x < src.cols; x++) {
-                if (dilated.at<uchar>(y, x) == 0 && src_complement.at<uchar>(y, x) == 0) {
-                    Xk.at<uchar>(y, x) = 0;
-                }
-            }
-        }
-
-    } while (countNonZero(Xk != Xk_prev) > 0);
-
-
-    return Xk;
+Mat regionFilling(const Mat& src, const vector<Point>& seeds) {
+    if (seeds.empty()) {
+        return regionFilling(src, {Point(src.cols / 2, src.rows / 2)});
+    }
+    return Reconstruction::fillRegion(BitImage::fromMat(src), seeds).toMat();
 }
 
 
@@ -109,19 +93,7 @@ void runBoundaryExtraction() {
 
 
 Mat boundaryExtraction(const Mat& src) {
-    Mat eroded = erosion(src);
-
-    auto result = Mat(src.size(), src.type(), Scalar(255));
-
-    for (int y = 0; y < src.rows; y++) {
-        for (int x = 0; x < src.cols; x++) {
-            if (src.at<uchar>(y, x) == 0 && eroded.at<uchar>(y, x) != 0) {
-                result.at<uchar>(y, x) = 0;
-            }
-        }
-    }
-
-    return result;
+    return MorphExpr().boundary().evaluate(src);
 }
 
 
@@ -132,8 +104,11 @@ void runOpening() {
         return;
     }
     const Mat opened = opening(src);
+    const StructuringElement disc = StructuringElement::disc(3);
+    const Mat openedDisc = runTiled(src, {TileExecutor::erode(disc), TileExecutor::dilate(disc)});
     imshow("Original", src);
     imshow("Opened", opened);
+    imshow("Opened (disc)", openedDisc);
     while (waitKey(0) & 0xFF != 27) {}
 }
 
@@ -143,56 +118,29 @@ void runClosing() {
         std::cerr << "Error: Could not open or find the image!" << std::endl;
         return;
     }
-    const Mat closed = runNTimes(src, 5, closing);
+    // Closing is idempotent: one pass gives the same image as the five
+    // repeated closings this demo used to run.
+    const Mat closed = closing(src);
     imshow("Original", src);
     imshow("Closed", closed);
     while (waitKey(0) & 0xFF != 27) {}
 }
 
 Mat opening(const Mat& src) {
-    return dilate(erosion(src));
+    return MorphExpr().opening().evaluate(src);
 }
 
 Mat closing(const Mat &src) {
-    return erosion(dilate(src));
+    return MorphExpr().closing().evaluate(src);
 }
 
 
-Mat runNTimes(const Mat& src, unsigned int n, Mat (*func)(const Mat&)) {
-    Mat result = src.clone();
-    for (unsigned int i = 0; i < n; ++i) {
-        result = func(result);
-    }
-    return result;
+Mat runTiled(const Mat& src, const vector<TileStage>& stages) {
+    return TileExecutor().run(BitImage::fromMat(src), stages).toMat();
 }
 
 Mat erosion(const Mat& src) {
-    auto result = Mat(src.size(), src.type(), Scalar(255));
-
-    for (int y = 0; y < src.rows; y++) {
-        for (int x = 0; x < src.cols; x++) {
-            if (src.at<uchar>(y, x) == 0) {
-                bool allNeighborsBlack = true;
-
-                for (int i = 0; i < 4; i++) {
-                    const int newX = x + dx[i];
-                    const int newY = y + dy[i];
-
-                    if (newX < 0 || newX >= src.cols || newY < 0 || newY >= src.rows ||
-                        src.at<uchar>(newY, newX) == 255) {
-                        allNeighborsBlack = false;
-                        break;
-                        }
-                }
-
-                if (allNeighborsBlack) {
-                    result.at<uchar>(y, x) = 0;
-                }
-            }
-        }
-    }
-
-    return result;
+    return runTiled(src, {TileExecutor::erode()});
 }
 
 
@@ -203,7 +151,7 @@ void runErosion() {
         return;
     }
 
-    const Mat eroded = runNTimes(src, 10, erosion);
+    const Mat eroded = DistanceTransform::erode(BitImage::fromMat(src), 10).toMat();
     imshow("Original", src);
     imshow("Eroded", eroded);
     while (waitKey(0) & 0xFF != 27) {}
@@ -211,24 +159,7 @@ void runErosion() {
 
 
 Mat dilate(const Mat& src){
-    auto result = Mat(src.size(), src.type(), Scalar(255));
-
-    for (int y = 0; y < src.rows; y++) {
-        for (int x = 0; x < src.cols; x++) {
-            if (src.at<uchar>(y, x) == 0) {
-                for (int i = 0; i < 4; i++) {
-                    const int newX = x + dx[i];
-                    const int newY = y + dy[i];
-
-                    if (newX >= 0 && newX < src.cols && newY >= 0 && newY < src.rows) {
-                        result.at<uchar>(newY, newX) = 0;
-                    }
-                }
-            }
-        }
-    }
-
-    return result;
+    return runTiled(src, {TileExecutor::dilate()});
 }
 
 void runDilate() {
@@ -0,0 +1,166 @@
+#include "Clahe.h"
+
+#include <algorithm>
+#include <cmath>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define CLAHE_AVX2_DISPATCH 1
+#endif
+
+#ifdef CLAHE_AVX2_DISPATCH
+namespace {
+    // Eight pixels of the inner blend: each gathers its entry from both 8.8
+    // tables and mixes them with the same integer formula as the scalar
+    // loop. The tables are read four bytes at a time, so each needs one
+    // readable uint16 past its end.
+    __attribute__((target("avx2")))
+    __m256i blend8(const uchar* in, const uint32_t* rightWeight, const int* left, const int* right) {
+        const __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in)));
+        const __m256i xa = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rightWeight));
+        const __m256i low16 = _mm256_set1_epi32(0xFFFF);
+        const __m256i l = _mm256_and_si256(_mm256_i32gather_epi32(left, v, 2), low16);
+        const __m256i r = _mm256_and_si256(_mm256_i32gather_epi32(right, v, 2), low16);
+        const __m256i sum = _mm256_add_epi32(_mm256_mullo_epi32(l, _mm256_sub_epi32(_mm256_set1_epi32(256), xa)),
+                                             _mm256_add_epi32(_mm256_mullo_epi32(r, xa), _mm256_set1_epi32(1 << 15)));
+        return _mm256_srli_epi32(sum, 16);
+    }
+
+    // The inner blend for columns c .. end - 1, 16 pixels at a time.
+    // Returns the first column not done.
+    __attribute__((target("avx2")))
+    int blendAvx2(const uchar* in, const uint32_t* rightWeight, const uint16_t* left, const uint16_t* right,
+                  uchar* out, int c, const int end) {
+        const auto* leftWords = reinterpret_cast<const int*>(left);
+        const auto* rightWords = reinterpret_cast<const int*>(right);
+        for (; c + 16 <= end; c += 16) {
+            const __m256i low = blend8(in + c, rightWeight + c, leftWords, rightWords);
+            const __m256i high = blend8(in + c + 8, rightWeight + c + 8, leftWords, rightWords);
+            // packus works within 128-bit lanes; the permute puts the 16
+            // results back in column order.
+            const __m256i words = _mm256_permute4x64_epi64(_mm256_packus_epi32(low, high), 0xD8);
+            const __m128i bytes = _mm_packus_epi16(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + c), bytes);
+        }
+        return c;
+    }
+
+    bool hasAvx2() {
+        static const bool supported = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+        }();
+        return supported;
+    }
+}
+#endif
+
+void Clahe::clip(Histogram& histogram, const uint64_t limit) {
+    uint64_t excess = 0;
+    for (uint64_t& count : histogram.counts) {
+        if (count > limit) {
+            excess += count - limit;
+            count = limit;
+        }
+    }
+
+    const uint64_t batch = excess / 256;
+    uint64_t residual = excess - batch * 256;
+    for (uint64_t& count : histogram.counts) {
+        count += batch;
+    }
+    const uint64_t step = residual > 0 ? std::max<uint64_t>(256 / residual, 1) : 1;
+    for (uint64_t i = 0; i < 256 && residual > 0; i += step, residual--) {
+        histogram.counts[i]++;
+    }
+}
+
+std::vector<Lut> Clahe::tileTables(const cv::Mat& img, const cv::Size grid, const double clipLimit) {
+    std::vector<Lut> tables(static_cast<size_t>(grid.area()));
+
+    cv::parallel_for_(cv::Range(0, grid.area()), [&](const cv::Range& range) {
+        for (int t = range.start; t < range.end; t++) {
+            const int tx = t % grid.width;
+            const int ty = t / grid.width;
+            const int x0 = img.cols * tx / grid.width;
+            const int y0 = img.rows * ty / grid.height;
+            const cv::Rect tile(x0, y0, img.cols * (tx + 1) / grid.width - x0, img.rows * (ty + 1) / grid.height - y0);
+
+            Histogram histogram = Histogram::compute(img(tile));
+            if (clipLimit > 0) {
+                clip(histogram, std::max<uint64_t>(1, static_cast<uint64_t>(clipLimit * histogram.total / 256)));
+            }
+            tables[t] = Lut::equalization(histogram);
+        }
+    }, grid.area());
+
+    return tables;
+}
+
+cv::Mat Clahe::apply(const cv::Mat& img, cv::Size grid, const double clipLimit) {
+    CV_Assert(img.type() == CV_8UC1);
+    grid.width = std::clamp(grid.width, 1, std::max(1, img.cols));
+    grid.height = std::clamp(grid.height, 1, std::max(1, img.rows));
+
+    const std::vector<Lut> tables = tileTables(img, grid, clipLimit);
+    cv::Mat result(img.size(), CV_8UC1);
+
+    // Column placement is the same for every row: the tile centres split
+    // each row into spans sharing a left and right tile, and each column
+    // has a fixed-point weight (0 .. 256) for the right one.
+    const double tileWidth = static_cast<double>(img.cols) / grid.width;
+    std::vector<uint32_t> rightWeight(img.cols);
+    std::vector<int> spanEnd(grid.width + 1, img.cols);
+    for (int c = 0, span = 0; c < img.cols; c++) {
+        const double x = (c + 0.5) / tileWidth - 0.5;
+        const int tx = static_cast<int>(std::floor(x));
+        while (span < tx + 1) {
+            spanEnd[span++] = c;
+        }
+        rightWeight[c] = tx < 0 || tx + 1 >= grid.width ? (tx < 0 ? 256 : 0)
+                                                       : static_cast<uint32_t>(std::lround((x - tx) * 256));
+    }
+
+    const double tileHeight = static_cast<double>(img.rows) / grid.height;
+    const int stripes = std::max(1, std::min(img.rows, cv::getNumThreads() * 4));
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        // The row's tables: each tile column's top and bottom tables blended
+        // by the row's vertical weight, in 8.8 fixed point.
+        // One spare entry at the end keeps the four-byte gathers in bounds.
+        std::vector<uint16_t> blended(static_cast<size_t>(grid.width) * 256 + 1);
+
+        for (int s = range.start; s < range.end; s++) {
+            for (int r = img.rows * s / stripes; r < img.rows * (s + 1) / stripes; r++) {
+                const double y = (r + 0.5) / tileHeight - 0.5;
+                const int ty = static_cast<int>(std::floor(y));
+                const Lut* top = tables.data() + static_cast<size_t>(std::max(ty, 0)) * grid.width;
+                const Lut* bottom = tables.data() + static_cast<size_t>(std::min(ty + 1, grid.height - 1)) * grid.width;
+                const auto ya = static_cast<uint16_t>(ty < 0 ? 0 : std::lround((y - ty) * 256));
+                for (int tx = 0; tx < grid.width; tx++) {
+                    uint16_t* out = blended.data() + static_cast<size_t>(tx) * 256;
+                    for (int v = 0; v < 256; v++) {
+                        out[v] = static_cast<uint16_t>(top[tx].table[v] * (256 - ya) + bottom[tx].table[v] * ya);
+                    }
+                }
+
+                const uchar* in = img.ptr<uchar>(r);
+                uchar* out = result.ptr<uchar>(r);
+                for (int span = 0, c = 0; span <= grid.width; span++) {
+                    const uint16_t* left = blended.data() + static_cast<size_t>(std::max(span - 1, 0)) * 256;
+                    const uint16_t* right = blended.data() + static_cast<size_t>(std::min(span, grid.width - 1)) * 256;
+#ifdef CLAHE_AVX2_DISPATCH
+                    if (hasAvx2()) {
+                        c = blendAvx2(in, rightWeight.data(), left, right, out, c, spanEnd[span]);
+                    }
+#endif
+                    for (; c < spanEnd[span]; c++) {
+                        const uchar v = in[c];
+                        const uint32_t xa = rightWeight[c];
+                        out[c] = static_cast<uchar>((left[v] * (256 - xa) + right[v] * xa + (1u << 15)) >> 16);
+                    }
+                }
+            }
+        }
+    }, stripes);
+
+    return result;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "Histogram.h"
+#include "Lut.h"
+
+// Contrast-limited adaptive histogram equalization of CV_8UC1 images. Each
+// tile of a grid gets its own equalization table from a clipped histogram;
+// every pixel blends the tables of the four tiles whose centres surround it.
+class Clahe {
+public:
+    // clipLimit caps each histogram bin at clipLimit times the mean bin
+    // height of a tile (0 disables clipping); the excess is spread evenly
+    // over all bins.
+    static cv::Mat apply(const cv::Mat& img, cv::Size grid = cv::Size(8, 8), double clipLimit = 40.0);
+
+private:
+    static void clip(Histogram& histogram, uint64_t limit);
+
+    // Tile tables in row-major grid order.
+    static std::vector<Lut> tileTables(const cv::Mat& img, cv::Size grid, double clipLimit);
+};
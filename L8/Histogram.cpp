@@ -0,0 +1,144 @@
+#include "Histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+Histogram Histogram::compute(const cv::Mat& img) {
+    CV_Assert(img.type() == CV_8UC1 || img.type() == CV_16UC1);
+    if (img.type() == CV_16UC1) {
+        return compute16(img);
+    }
+
+    const int stripes = std::max(1, std::min(img.rows, cv::getNumThreads() * 4));
+    std::vector<std::vector<uint64_t>> partial(stripes);
+
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; s++) {
+            // Four interleaved tables, so runs of equal pixels do not wait on
+            // each other's increments.
+            std::vector<uint64_t> local(4 * 256, 0);
+            for (int r = img.rows * s / stripes; r < img.rows * (s + 1) / stripes; r++) {
+                const uchar* row = img.ptr<uchar>(r);
+                int c = 0;
+                for (; c + 4 <= img.cols; c += 4) {
+                    local[row[c]]++;
+                    local[256 + row[c + 1]]++;
+                    local[512 + row[c + 2]]++;
+                    local[768 + row[c + 3]]++;
+                }
+                for (; c < img.cols; c++) {
+                    local[row[c]]++;
+                }
+            }
+            partial[s] = std::move(local);
+        }
+    }, stripes);
+
+    Histogram histogram;
+    for (const auto& local : partial) {
+        for (int i = 0; i < 4 * 256; i++) {
+            histogram.counts[i % 256] += local[i];
+        }
+    }
+    histogram.total = static_cast<uint64_t>(img.rows) * img.cols;
+    return histogram;
+}
+
+Histogram Histogram::compute16(const cv::Mat& img) {
+    Histogram histogram;
+    histogram.counts.assign(65536, 0);
+    histogram.total = static_cast<uint64_t>(img.rows) * img.cols;
+
+    // Keeping a 512 KB table for every stripe until the end would be
+    // wasteful, so each range reuses one and folds it into the result after
+    // every stripe.
+    const int stripes = std::max(1, std::min(img.rows, cv::getNumThreads() * 4));
+    std::mutex merge;
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        std::vector<uint64_t> local(65536);
+        for (int s = range.start; s < range.end; s++) {
+            std::ranges::fill(local, 0);
+            for (int r = img.rows * s / stripes; r < img.rows * (s + 1) / stripes; r++) {
+                const auto* row = img.ptr<ushort>(r);
+                for (int c = 0; c < img.cols; c++) {
+                    local[row[c]]++;
+                }
+            }
+            std::lock_guard lock(merge);
+            for (int i = 0; i < 65536; i++) {
+                histogram.counts[i] += local[i];
+            }
+        }
+    }, stripes);
+
+    return histogram;
+}
+
+int Histogram::min() const {
+    const auto it = std::ranges::find_if(counts, [](const uint64_t count) { return count != 0; });
+    return it == counts.end() ? 0 : static_cast<int>(it - counts.begin());
+}
+
+int Histogram::max() const {
+    for (int i = static_cast<int>(counts.size()) - 1; i >= 0; i--) {
+        if (counts[i] != 0) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+std::vector<uint64_t> Histogram::cumulative() const {
+    std::vector<uint64_t> result(counts.size());
+    uint64_t sum = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        sum += counts[i];
+        result[i] = sum;
+    }
+    return result;
+}
+
+int Histogram::percentile(const double p) const {
+    const auto rank = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(total)));
+    uint64_t sum = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        sum += counts[i];
+        if (sum >= std::max<uint64_t>(rank, 1)) {
+            return static_cast<int>(i);
+        }
+    }
+    return 0;
+}
+
+ImageStats ImageStats::fromHistogram(const Histogram& histogram) {
+    ImageStats stats;
+    stats.count = histogram.total;
+    if (stats.count == 0) {
+        return stats;
+    }
+
+    // The sum is exact in 64 bits for either depth; the spread is taken
+    // about the mean so squares of 16-bit levels cannot overflow.
+    uint64_t sum = 0;
+    for (size_t i = 0; i < histogram.counts.size(); i++) {
+        sum += i * histogram.counts[i];
+    }
+    const auto n = static_cast<double>(stats.count);
+    stats.mean = static_cast<double>(sum) / n;
+
+    double spread = 0.0;
+    for (size_t i = 0; i < histogram.counts.size(); i++) {
+        if (histogram.counts[i] != 0) {
+            const double d = static_cast<double>(i) - stats.mean;
+            spread += d * d * static_cast<double>(histogram.counts[i]);
+        }
+    }
+
+    stats.min = histogram.min();
+    stats.max = histogram.max();
+    stats.median = histogram.percentile(0.5);
+    stats.variance = spread / n;
+    stats.stdDev = std::sqrt(stats.variance);
+    return stats;
+}
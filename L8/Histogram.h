@@ -0,0 +1,42 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <vector>
+
+// Pixel counts per grey level of a CV_8UC1 (256 bins) or CV_16UC1 (65536
+// bins) image. Counters are 64-bit, so no image is too large to count.
+struct Histogram {
+    std::vector<uint64_t> counts = std::vector<uint64_t>(256, 0);
+    uint64_t total = 0;
+
+    // One parallel pass over the image: each stripe counts into private
+    // histograms that are summed at the end.
+    static Histogram compute(const cv::Mat& img);
+
+    // Lowest and highest level present; 0 for an empty histogram.
+    [[nodiscard]] int min() const;
+    [[nodiscard]] int max() const;
+
+    [[nodiscard]] std::vector<uint64_t> cumulative() const;
+
+    // Lowest level at or below which a fraction p (0 .. 1) of the pixels lie.
+    [[nodiscard]] int percentile(double p) const;
+
+private:
+    static Histogram compute16(const cv::Mat& img);
+};
+
+// Every statistic computeImageStats reports, derived from the histogram in
+// O(levels) rather than by further passes over the pixels.
+struct ImageStats {
+    uint64_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double median = 0.0;
+    double mean = 0.0;
+    double variance = 0.0;
+    double stdDev = 0.0;
+
+    static ImageStats fromHistogram(const Histogram& histogram);
+};
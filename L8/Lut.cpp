@@ -0,0 +1,169 @@
+#include "Lut.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#define LUT_VBMI_DISPATCH 1
+#endif
+
+namespace {
+    template<typename T>
+    constexpr double fullScale = std::numeric_limits<T>::max();
+}
+
+template<typename T>
+std::vector<T> LevelTable<T>::stretch(const int inMin, const int inMax, const double outMin, const double outMax) {
+    std::vector<T> table(static_cast<size_t>(fullScale<T>) + 1);
+    for (int i = 0; i < static_cast<int>(table.size()); i++) {
+        const double value = inMax == inMin ? outMin : outMin + (i - inMin) * (outMax - outMin) / (inMax - inMin);
+        table[i] = static_cast<T>(std::clamp(std::trunc(value), 0.0, fullScale<T>));
+    }
+    return table;
+}
+
+template<typename T>
+std::vector<T> LevelTable<T>::gamma(const double gamma) {
+    std::vector<T> table(static_cast<size_t>(fullScale<T>) + 1);
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = cv::saturate_cast<T>(std::pow(static_cast<double>(i) / fullScale<T>, gamma) * fullScale<T>);
+    }
+    return table;
+}
+
+template<typename T>
+std::vector<T> LevelTable<T>::equalization(const Histogram& histogram) {
+    CV_Assert(histogram.counts.size() == static_cast<size_t>(fullScale<T>) + 1);
+    const std::vector<uint64_t> cumulative = histogram.cumulative();
+    const auto total = static_cast<double>(std::max<uint64_t>(histogram.total, 1));
+
+    std::vector<T> table(cumulative.size());
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = cv::saturate_cast<T>(fullScale<T> * static_cast<double>(cumulative[i]) / total);
+    }
+    return table;
+}
+
+template struct LevelTable<uchar>;
+template struct LevelTable<ushort>;
+
+Lut Lut::identity() {
+    Lut lut;
+    for (int i = 0; i < 256; i++) {
+        lut.table[i] = static_cast<uchar>(i);
+    }
+    return lut;
+}
+
+Lut Lut::fromTable(const std::vector<uchar>& table) {
+    CV_Assert(table.size() == 256);
+    Lut lut;
+    std::ranges::copy(table, lut.table.begin());
+    return lut;
+}
+
+Lut Lut::stretch(const int inMin, const int inMax, const double outMin, const double outMax) {
+    return fromTable(LevelTable<uchar>::stretch(inMin, inMax, outMin, outMax));
+}
+
+Lut Lut::gamma(const double gamma) {
+    return fromTable(LevelTable<uchar>::gamma(gamma));
+}
+
+Lut Lut::equalization(const Histogram& histogram) {
+    return fromTable(LevelTable<uchar>::equalization(histogram));
+}
+
+Lut Lut::then(const Lut& next) const {
+    Lut lut;
+    for (int i = 0; i < 256; i++) {
+        lut.table[i] = next.table[table[i]];
+    }
+    return lut;
+}
+
+Histogram Lut::map(const Histogram& histogram) const {
+    CV_Assert(histogram.counts.size() == 256);
+    Histogram result;
+    for (int i = 0; i < 256; i++) {
+        result.counts[table[i]] += histogram.counts[i];
+    }
+    result.total = histogram.total;
+    return result;
+}
+
+#ifdef LUT_VBMI_DISPATCH
+namespace {
+    // vpermi2b indexes 128 bytes with the low seven bits of each pixel; the
+    // high bit picks between the two halves of the table. Built for
+    // AVX-512 VBMI whatever the compiler flags and only called when the CPU
+    // has it. Returns the number of pixels done, a multiple of 64.
+    __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+    int applyVbmi(const uchar* table, const uchar* in, uchar* out, const int n) {
+        const __m512i t0 = _mm512_loadu_si512(table);
+        const __m512i t1 = _mm512_loadu_si512(table + 64);
+        const __m512i t2 = _mm512_loadu_si512(table + 128);
+        const __m512i t3 = _mm512_loadu_si512(table + 192);
+        int c = 0;
+        for (; c + 64 <= n; c += 64) {
+            const __m512i x = _mm512_loadu_si512(in + c);
+            const __m512i low = _mm512_permutex2var_epi8(t0, x, t1);
+            const __m512i high = _mm512_permutex2var_epi8(t2, x, t3);
+            _mm512_storeu_si512(out + c, _mm512_mask_blend_epi8(_mm512_movepi8_mask(x), low, high));
+        }
+        return c;
+    }
+
+    bool hasVbmi() {
+        static const bool supported = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vbmi");
+        }();
+        return supported;
+    }
+}
+#endif
+
+void Lut::applyRow(const uchar* in, uchar* out, const int n) const {
+    int c = 0;
+#ifdef LUT_VBMI_DISPATCH
+    if (hasVbmi()) {
+        c = applyVbmi(table.data(), in, out, n);
+    }
+#endif
+    for (; c < n; c++) {
+        out[c] = table[in[c]];
+    }
+}
+
+void Lut::apply(const cv::Mat& src, cv::Mat& dst) const {
+    CV_Assert(src.type() == CV_8UC1);
+    if (dst.data != src.data) {
+        dst.create(src.size(), CV_8UC1);
+    }
+
+    // A continuous image is cut as one long row, so short wide and tall
+    // narrow images split evenly; otherwise stripes take whole rows.
+    if (src.isContinuous() && dst.isContinuous()) {
+        const auto length = static_cast<int64_t>(src.total());
+        const int stripes = static_cast<int>(std::clamp<int64_t>(length / 4096, 1, cv::getNumThreads() * 4));
+        cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+            for (int s = range.start; s < range.end; s++) {
+                const int64_t begin = length * s / stripes / 64 * 64;
+                const int64_t end = s + 1 == stripes ? length : length * (s + 1) / stripes / 64 * 64;
+                applyRow(src.data + begin, dst.data + begin, static_cast<int>(end - begin));
+            }
+        }, stripes);
+        return;
+    }
+
+    const int stripes = std::max(1, std::min(src.rows, cv::getNumThreads() * 4));
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; s++) {
+            for (int r = src.rows * s / stripes; r < src.rows * (s + 1) / stripes; r++) {
+                applyRow(src.ptr<uchar>(r), dst.ptr<uchar>(r), src.cols);
+            }
+        }
+    }, stripes);
+}
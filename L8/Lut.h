@@ -0,0 +1,50 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <array>
+#include <vector>
+#include "Histogram.h"
+
+// Point operation tables with one entry per level of an integer pixel type:
+// 256 for uchar, 65536 for ushort. Lut's factories are the uchar case.
+template<typename T>
+struct LevelTable {
+    // [inMin, inMax] onto [outMin, outMax], truncated and clamped to the
+    // type's range.
+    static std::vector<T> stretch(int inMin, int inMax, double outMin, double outMax);
+    // Levels are taken relative to the type's full scale.
+    static std::vector<T> gamma(double gamma);
+    // histogram must have one bin per level.
+    static std::vector<T> equalization(const Histogram& histogram);
+};
+
+// A 256-entry point operation on CV_8UC1 images. Tables compose, so a chain
+// of point operations costs one table and one pass over the pixels.
+struct Lut {
+    std::array<uchar, 256> table{};
+
+    static Lut identity();
+    static Lut fromTable(const std::vector<uchar>& table);
+
+    // The linear map histogramStretchShrink applies: [inMin, inMax] onto
+    // [outMin, outMax], truncated and clamped to 0 .. 255.
+    static Lut stretch(int inMin, int inMax, double outMin, double outMax);
+    static Lut gamma(double gamma);
+    static Lut equalization(const Histogram& histogram);
+
+    // This table followed by next.
+    [[nodiscard]] Lut then(const Lut& next) const;
+
+    // The histogram of an image after this table is applied to it, so a
+    // histogram-dependent table can be chained without a pass over pixels.
+    [[nodiscard]] Histogram map(const Histogram& histogram) const;
+
+    // dst may be src, in which case the image is rewritten in place. Rows
+    // are split across threads. On x86-64 CPUs with AVX-512 VBMI, detected
+    // at run time, each 64 pixels are looked up by two vpermi2b and a
+    // blend; otherwise by plain table reads.
+    void apply(const cv::Mat& src, cv::Mat& dst) const;
+
+private:
+    void applyRow(const uchar* in, uchar* out, int n) const;
+};
@@ -0,0 +1,144 @@
+#include "PointOps.h"
+
+#include <algorithm>
+#include <cmath>
+#include "Lut.h"
+
+template<typename T>
+ImageStats PointOps<T>::stats(const cv::Mat& img, Histogram* histogram) {
+    Histogram counted = Histogram::compute(img);
+    const ImageStats result = ImageStats::fromHistogram(counted);
+    if (histogram != nullptr) {
+        *histogram = std::move(counted);
+    }
+    return result;
+}
+
+template<typename T>
+cv::Mat PointOps<T>::stretch(const cv::Mat& img, const double outMin, const double outMax) {
+    const Histogram histogram = Histogram::compute(img);
+    return applyTable(img, LevelTable<T>::stretch(histogram.min(), histogram.max(), outMin, outMax));
+}
+
+template<typename T>
+cv::Mat PointOps<T>::gamma(const cv::Mat& img, const double gamma) {
+    return applyTable(img, LevelTable<T>::gamma(gamma));
+}
+
+template<typename T>
+cv::Mat PointOps<T>::equalize(const cv::Mat& img) {
+    return applyTable(img, LevelTable<T>::equalization(Histogram::compute(img)));
+}
+
+template<typename T>
+cv::Mat PointOps<T>::applyTable(const cv::Mat& img, const std::vector<T>& table) {
+    cv::Mat result;
+    if constexpr (sizeof(T) == 1) {
+        Lut::fromTable(table).apply(img, result);
+    } else {
+        result.create(img.size(), img.type());
+        const int stripes = std::max(1, std::min(img.rows, cv::getNumThreads() * 4));
+        cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+            for (int s = range.start; s < range.end; s++) {
+                for (int r = img.rows * s / stripes; r < img.rows * (s + 1) / stripes; r++) {
+                    const T* in = img.ptr<T>(r);
+                    T* out = result.ptr<T>(r);
+                    for (int c = 0; c < img.cols; c++) {
+                        out[c] = table[in[c]];
+                    }
+                }
+            }
+        }, stripes);
+    }
+    return result;
+}
+
+template<>
+ImageStats PointOps<float>::stats(const cv::Mat& img, Histogram*) {
+    CV_Assert(img.type() == CV_32FC1);
+
+    ImageStats stats;
+    stats.count = img.total();
+    if (stats.count == 0) {
+        return stats;
+    }
+
+    cv::Scalar mean, stdDev;
+    cv::meanStdDev(img, mean, stdDev);
+    cv::minMaxLoc(img, &stats.min, &stats.max);
+    stats.mean = mean[0];
+    stats.stdDev = stdDev[0];
+    stats.variance = stdDev[0] * stdDev[0];
+
+    // No histogram to read the median from: select it from a copy.
+    std::vector<float> values;
+    values.reserve(stats.count);
+    for (int r = 0; r < img.rows; r++) {
+        values.insert(values.end(), img.ptr<float>(r), img.ptr<float>(r) + img.cols);
+    }
+    const auto middle = values.begin() + static_cast<std::ptrdiff_t>((stats.count - 1) / 2);
+    std::nth_element(values.begin(), middle, values.end());
+    stats.median = *middle;
+    return stats;
+}
+
+template<>
+cv::Mat PointOps<float>::stretch(const cv::Mat& img, const double outMin, const double outMax) {
+    CV_Assert(img.type() == CV_32FC1);
+
+    double inMin = 0.0, inMax = 0.0;
+    cv::minMaxLoc(img, &inMin, &inMax);
+    const double scale = inMax > inMin ? (outMax - outMin) / (inMax - inMin) : 0.0;
+
+    cv::Mat result;
+    img.convertTo(result, CV_32F, scale, outMin - inMin * scale);
+    return result;
+}
+
+template<>
+cv::Mat PointOps<float>::gamma(const cv::Mat& img, const double gamma) {
+    CV_Assert(img.type() == CV_32FC1);
+
+    cv::Mat result;
+    cv::pow(img, gamma, result);
+    return result;
+}
+
+template<>
+cv::Mat PointOps<float>::equalize(const cv::Mat& img) {
+    CV_Assert(img.type() == CV_32FC1);
+
+    double inMin = 0.0, inMax = 0.0;
+    cv::minMaxLoc(img, &inMin, &inMax);
+    const double scale = inMax > inMin ? 65535.0 / (inMax - inMin) : 0.0;
+
+    // Quantize to 16 bits and equalize those bins, keeping the table in float.
+    cv::Mat bins;
+    img.convertTo(bins, CV_16U, scale, -inMin * scale);
+    const Histogram histogram = Histogram::compute(bins);
+    const std::vector<uint64_t> cumulative = histogram.cumulative();
+    const auto total = static_cast<double>(std::max<uint64_t>(histogram.total, 1));
+
+    std::vector<float> table(cumulative.size());
+    for (size_t i = 0; i < table.size(); i++) {
+        table[i] = static_cast<float>(static_cast<double>(cumulative[i]) / total);
+    }
+
+    cv::Mat result(img.size(), CV_32FC1);
+    const int stripes = std::max(1, std::min(img.rows, cv::getNumThreads() * 4));
+    cv::parallel_for_(cv::Range(0, stripes), [&](const cv::Range& range) {
+        for (int s = range.start; s < range.end; s++) {
+            for (int r = img.rows * s / stripes; r < img.rows * (s + 1) / stripes; r++) {
+                const auto* in = bins.ptr<ushort>(r);
+                auto* out = result.ptr<float>(r);
+                for (int c = 0; c < img.cols; c++) {
+                    out[c] = table[in[c]];
+                }
+            }
+        }
+    }, stripes);
+    return result;
+}
+
+template class PointOps<uchar>;
+template class PointOps<ushort>;
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <vector>
+#include "Histogram.h"
+
+// The L8 point operations for one pixel type, chosen at compile time.
+// uchar and ushort images go through LevelTable tables with one entry per
+// level (256 or 65536) built from histograms with one bin per level; uchar
+// tables run on the Lut kernel. float images have no levels to tabulate and are
+// evaluated with OpenCV's vectorized arithmetic instead.
+template<typename T>
+class PointOps {
+public:
+    // When histogram is given it receives the histogram the statistics were
+    // derived from (integer types only).
+    static ImageStats stats(const cv::Mat& img, Histogram* histogram = nullptr);
+
+    // [min, max] of the image onto [outMin, outMax]; integer results are
+    // truncated and clamped to the type's range.
+    static cv::Mat stretch(const cv::Mat& img, double outMin, double outMax);
+
+    // Levels are taken relative to the type's full scale: 255, 65535, or 1
+    // for float.
+    static cv::Mat gamma(const cv::Mat& img, double gamma);
+
+    // float images are equalized over 65536 bins spanning [min, max] and
+    // map to [0, 1].
+    static cv::Mat equalize(const cv::Mat& img);
+
+private:
+    static cv::Mat applyTable(const cv::Mat& img, const std::vector<T>& table);
+};
+
+template<> ImageStats PointOps<float>::stats(const cv::Mat& img, Histogram* histogram);
+template<> cv::Mat PointOps<float>::stretch(const cv::Mat& img, double outMin, double outMax);
+template<> cv::Mat PointOps<float>::gamma(const cv::Mat& img, double gamma);
+template<> cv::Mat PointOps<float>::equalize(const cv::Mat& img);
+
+// Calls f.template operator()<T>() with T the pixel type of a CV_8UC1,
+// CV_16UC1 or CV_32FC1 image.
+template<typename F>
+decltype(auto) withDepth(const cv::Mat& img, F&& f) {
+    CV_Assert(img.channels() == 1);
+    switch (img.depth()) {
+        case CV_8U:
+            return f.template operator()<uchar>();
+        case CV_16U:
+            return f.template operator()<ushort>();
+        case CV_32F:
+            return f.template operator()<float>();
+        default:
+            CV_Error(cv::Error::StsUnsupportedFormat, "expected an 8U, 16U or 32F image");
+    }
+}
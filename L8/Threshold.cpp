@@ -0,0 +1,117 @@
+#include "Threshold.h"
+
+#include <algorithm>
+#include <cmath>
+
+MomentTables::MomentTables(const Histogram& histogram)
+    : count(histogram.counts.size() + 1, 0), sum(histogram.counts.size() + 1, 0) {
+    for (size_t i = 0; i < histogram.counts.size(); i++) {
+        count[i + 1] = count[i] + histogram.counts[i];
+        sum[i + 1] = sum[i] + i * histogram.counts[i];
+    }
+}
+
+double Threshold::iterative(const Histogram& histogram, const double error) {
+    const MomentTables tables(histogram);
+    const int minVal = histogram.min();
+    const int maxVal = histogram.max();
+
+    const auto mean = [&](const int lo, const int hi) {
+        const uint64_t n = lo <= hi ? tables.countIn(lo, hi) : 0;
+        return n > 0 ? static_cast<double>(tables.sumIn(lo, hi)) / static_cast<double>(n) : 0.0;
+    };
+
+    double t = (minVal + maxVal) / 2.0;
+    double previous;
+    do {
+        previous = t;
+        const int split = static_cast<int>(t);
+        t = (mean(minVal, split) + mean(split + 1, maxVal)) / 2.0;
+    } while (std::abs(t - previous) >= error);
+    return t;
+}
+
+int Threshold::otsu(const Histogram& histogram) {
+    const MomentTables tables(histogram);
+    const int levels = static_cast<int>(histogram.counts.size());
+    const auto total = static_cast<double>(tables.count[levels]);
+    const auto totalSum = static_cast<double>(tables.sum[levels]);
+
+    // Between-class variance times total^2:
+    // (total * sum(<= t) - totalSum * count(<= t))^2 / (count(<= t) * count(> t)).
+    int best = 0;
+    double bestScore = -1.0;
+    for (int t = 0; t < levels - 1; t++) {
+        const auto n0 = static_cast<double>(tables.count[t + 1]);
+        const double n1 = total - n0;
+        if (n0 == 0 || n1 == 0) {
+            continue;
+        }
+        const double d = total * static_cast<double>(tables.sum[t + 1]) - totalSum * n0;
+        const double score = d * d / (n0 * n1);
+        if (score > bestScore) {
+            bestScore = score;
+            best = t;
+        }
+    }
+    return best;
+}
+
+std::vector<int> Threshold::multiOtsu(const Histogram& histogram, const int classes) {
+    const MomentTables tables(histogram);
+    const int levels = static_cast<int>(histogram.counts.size());
+    if (classes < 2 || classes > levels) {
+        return {};
+    }
+
+    // Maximising between-class variance is maximising the sum over classes
+    // of sum^2 / count, which splits into one term per class.
+    const auto term = [&](const int lo, const int hi) {
+        const uint64_t n = tables.countIn(lo, hi);
+        if (n == 0) {
+            return 0.0;
+        }
+        const auto s = static_cast<double>(tables.sumIn(lo, hi));
+        return s * s / static_cast<double>(n);
+    };
+
+    // score[k][j]: best total for levels 0 .. j in k + 1 classes, each at
+    // least one level wide; from[k][j] is the last level of class k - 1.
+    // The best split point never moves left as j grows (the class sums
+    // obey the quadrangle inequality), so each row is filled by divide and
+    // conquer in O(L log L).
+    std::vector score(classes, std::vector(levels, 0.0));
+    std::vector from(classes, std::vector(levels, 0));
+    for (int j = 0; j < levels; j++) {
+        score[0][j] = term(0, j);
+    }
+    for (int k = 1; k < classes; k++) {
+        const auto solve = [&](const auto& self, const int lo, const int hi, const int splitLo, const int splitHi) {
+            if (lo > hi) {
+                return;
+            }
+            const int j = (lo + hi) / 2;
+            double best = -1.0;
+            int split = splitLo;
+            for (int i = splitLo; i <= std::min(splitHi, j - 1); i++) {
+                const double candidate = score[k - 1][i] + term(i + 1, j);
+                if (candidate > best) {
+                    best = candidate;
+                    split = i;
+                }
+            }
+            score[k][j] = best;
+            from[k][j] = split;
+            self(self, lo, j - 1, splitLo, split);
+            self(self, j + 1, hi, split, splitHi);
+        };
+        solve(solve, k, levels - 1, k - 1, levels - 2);
+    }
+
+    std::vector<int> thresholds(classes - 1);
+    for (int k = classes - 1, j = levels - 1; k > 0; k--) {
+        j = from[k][j];
+        thresholds[k - 1] = j;
+    }
+    return thresholds;
+}
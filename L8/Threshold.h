@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "Histogram.h"
+
+// Cumulative pixel count and grey-level sum tables of a histogram, so the
+// count and sum of any range of levels cost two lookups each.
+struct MomentTables {
+    // count[i] and sum[i] cover levels 0 .. i - 1.
+    std::vector<uint64_t> count;
+    std::vector<uint64_t> sum;
+
+    explicit MomentTables(const Histogram& histogram);
+
+    // Levels lo .. hi inclusive.
+    [[nodiscard]] uint64_t countIn(const int lo, const int hi) const { return count[hi + 1] - count[lo]; }
+    [[nodiscard]] uint64_t sumIn(const int lo, const int hi) const { return sum[hi + 1] - sum[lo]; }
+};
+
+// Global thresholds chosen from the histogram alone. Levels up to and
+// including a threshold form the lower class, as with THRESH_BINARY.
+class Threshold {
+public:
+    // The iterative mean-of-means threshold computeThreshold has always
+    // used, started from the middle of the occupied range; each iteration
+    // is O(1).
+    static double iterative(const Histogram& histogram, double error = 0.1);
+
+    // Otsu's threshold: the level maximising between-class variance, found
+    // in one O(L) sweep of the tables.
+    static int otsu(const Histogram& histogram);
+
+    // classes - 1 increasing thresholds maximising between-class variance,
+    // found by dynamic programming over the tables in O(classes * L log L).
+    static std::vector<int> multiOtsu(const Histogram& histogram, int classes);
+};
@@ -1,24 +1,30 @@
 #include <iostream>
+#include <numeric>
 #include <string>
 #include <opencv2/opencv.hpp>
 #include <opencv2/highgui/highgui.hpp>
 #include <opencv2/core/core.hpp>
 #include <opencv2/imgproc/imgproc.hpp>
+#include "Clahe.h"
+#include "Histogram.h"
+#include "Lut.h"
+#include "PointOps.h"
+#include "Threshold.h"
 
 using namespace cv;
 using namespace std;
 
-void showHistogram(const string& name, const vector<int>& hist, const int hist_cols, const int hist_height) {
+void showHistogram(const string& name, const vector<uint64_t>& hist, const int hist_cols, const int hist_height) {
     Mat imgHist(hist_height, hist_cols, CV_8UC3, CV_RGB(255, 255, 255));
-    int max_hist = 0;
+    uint64_t max_hist = 1;
     for (int i = 0; i < hist_cols; i++)
         if (hist[i] > max_hist)
             max_hist = hist[i];
-    const double scale = static_cast<double>(hist_height) / max_hist;
+    const double scale = static_cast<double>(hist_height) / static_cast<double>(max_hist);
     const int baseline = hist_height - 1;
     for (int x = 0; x < hist_cols; x++) {
         const auto p1 = Point(x, baseline);
-        const auto p2 = Point(x, baseline - cvRound(hist[x] * scale));
+        const auto p2 = Point(x, baseline - cvRound(static_cast<double>(hist[x]) * scale));
         line(imgHist, p1, p2, CV_RGB(255, 0, 255));
     }
     imshow(name, imgHist);
@@ -26,90 +32,37 @@ void showHistogram(const string& name, const vector<int>& hist, const int hist_c
 }
 
 void computeImageStats(const Mat& img) {
-    vector histogram(256,0);
-    vector cumHistogram(256,0);
-
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            histogram[img.at<uchar>(i, j)]++;
-        }
-    }
-
-    cumHistogram[0] = histogram[0];
-    for (int i = 1; i < histogram.size(); i++) {
-        cumHistogram[i] = cumHistogram[i - 1] + histogram[i];
-    }
-
-    double mean = 0.0;
-    const int M = img.rows * img.cols;
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            mean += img.at<uchar>(i, j);
-        }
-    }
-    mean /= M;
-
-    double stdDev = 0.0;
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            stdDev += pow(img.at<uchar>(i, j) - mean, 2);
-        }
-    }
-    stdDev /= M;
-    stdDev = sqrt(stdDev);
+    Histogram histogram;
+    const ImageStats stats = withDepth(img, [&]<typename T>() { return PointOps<T>::stats(img, &histogram); });
 
     cout << "Image Statistics:\n";
-    cout << "Mean: " << mean << "\n";
-    cout << "Standard Deviation: " << stdDev << "\n";
-
-    showHistogram("Histogram", histogram, 256, 200);
-    showHistogram("Cumulative Histogram", cumHistogram, 256, 200);
-}
-
-
-Mat computeThreshold(const Mat& img) {
-    vector histogram(256, 0);
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            histogram[img.at<uchar>(i, j)]++;
-        }
+    cout << "Mean: " << stats.mean << "\n";
+    cout << "Standard Deviation: " << stats.stdDev << "\n";
+    cout << "Min: " << stats.min << ", Max: " << stats.max << ", Median: " << stats.median << "\n";
+    if (histogram.total == 0) {
+        return;
     }
+    cout << "5th/95th percentile: " << histogram.percentile(0.05) << " / " << histogram.percentile(0.95) << "\n";
 
-    int min_val = 255, max_val = 0;
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            const int val = img.at<uchar>(i, j);
-            if (val < min_val) min_val = val;
-            if (val > max_val) max_val = val;
-        }
+    // 16-bit histograms are shown 256 levels to a column.
+    const size_t fold = histogram.counts.size() / 256;
+    vector<uint64_t> shown(256, 0);
+    for (size_t i = 0; i < histogram.counts.size(); i++) {
+        shown[i / fold] += histogram.counts[i];
     }
+    vector<uint64_t> cumulative(256);
+    partial_sum(shown.begin(), shown.end(), cumulative.begin());
 
-    double T = (min_val + max_val) / 2.0;
-    double T_prev;
-    double error = 0.1;
-
-    do {
-        T_prev = T;
-
-        int N1 = 0, N2 = 0;
-        double sum1 = 0.0, sum2 = 0.0;
-
-        for (int g = min_val; g <= T; g++) {
-            sum1 += g * histogram[g];
-            N1 += histogram[g];
-        }
-
-        for (int g = static_cast<int>(T) + 1; g <= max_val; g++) {
-            sum2 += g * histogram[g];
-            N2 += histogram[g];
-        }
+    showHistogram("Histogram", shown, 256, 200);
+    showHistogram("Cumulative Histogram", cumulative, 256, 200);
+}
 
-        const double mean_G1 = N1 > 0 ? sum1 / N1 : 0;
-        const double mean_G2 = N2 > 0 ? sum2 / N2 : 0;
 
-        T = (mean_G1 + mean_G2) / 2.0;
+enum class ThresholdMode { Iterative, Otsu };
 
-    } while (abs(T - T_prev) >= error);
+Mat computeThreshold(const Mat& img, const ThresholdMode mode = ThresholdMode::Iterative) {
+    const Histogram histogram = Histogram::compute(img);
+    const double T = mode == ThresholdMode::Otsu ? Threshold::otsu(histogram) : Threshold::iterative(histogram);
 
     Mat binary = img.clone();
     threshold(img, binary, T, 255, THRESH_BINARY);
@@ -119,99 +72,95 @@ Mat computeThreshold(const Mat& img) {
     return binary;
 }
 
-Mat histogramStretchShrink(const Mat& img, const int out_min, const int out_max) {
-    Mat result = img.clone();
-    int in_min = 255, in_max = 0;
-
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            const int val = img.at<uchar>(i, j);
-            if (val < in_min) in_min = val;
-            if (val > in_max) in_max = val;
-        }
-    }
+// Posterizes img into classes grey levels spread evenly over 0 .. 255,
+// split at the multi-level Otsu thresholds.
+Mat multiLevelThreshold(const Mat& img, const int classes) {
+    const vector<int> thresholds = Threshold::multiOtsu(Histogram::compute(img), classes);
 
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            double const val = img.at<uchar>(i, j);
-            int new_val = out_min + (val - in_min) * (out_max - out_min) / (in_max - in_min);
-            new_val = max(0, min(255, new_val));
-            result.at<uchar>(i, j) = new_val;
+    Mat lut(1, 256, CV_8UC1);
+    for (int i = 0, k = 0; i < 256; i++) {
+        while (k < static_cast<int>(thresholds.size()) && i > thresholds[k]) {
+            k++;
         }
+        lut.at<uchar>(0, i) = saturate_cast<uchar>(255.0 * k / max(1, classes - 1));
     }
 
+    Mat result;
+    LUT(img, lut, result);
     return result;
 }
 
-Mat gammaCorrection(const Mat& img, const double gamma) {
-    Mat result = img.clone();
-
-    unsigned char lut[256];
-    for (int i = 0; i < 256; i++) {
-        lut[i] = saturate_cast<uchar>(pow((i / 255.0), gamma) * 255.0);
-    }
-
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            result.at<uchar>(i, j) = lut[img.at<uchar>(i, j)];
-        }
-    }
+Mat histogramStretchShrink(const Mat& img, const double out_min, const double out_max) {
+    return withDepth(img, [&]<typename T>() { return PointOps<T>::stretch(img, out_min, out_max); });
+}
 
-    return result;
+Mat gammaCorrection(const Mat& img, const double gamma) {
+    return withDepth(img, [&]<typename T>() { return PointOps<T>::gamma(img, gamma); });
 }
 
 Mat histogramEqualization(const Mat& img) {
-    Mat result = img.clone();
-    const int M = img.rows * img.cols;
+    return withDepth(img, [&]<typename T>() { return PointOps<T>::equalize(img); });
+}
 
-    vector histogram(256, 0);
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            histogram[img.at<uchar>(i, j)]++;
-        }
-    }
+Mat adaptiveEqualization(const Mat& img, const Size grid = Size(8, 8), const double clipLimit = 40.0) {
+    return Clahe::apply(img, grid, clipLimit);
+}
 
-    vector pdf(256, 0.0);
-    for (int i = 0; i < 256; i++) {
-        pdf[i] = static_cast<double>(histogram[i]) / M;
-    }
+// Stretching, gamma correction and equalization in a single pass: the
+// equalization table is built from the histogram the first two tables would
+// produce, and all three are folded into one.
+Mat stretchGammaEqualize(const Mat& img, const double out_min, const double out_max, const double gamma) {
+    const Histogram histogram = Histogram::compute(img);
+    const Lut adjust = Lut::stretch(histogram.min(), histogram.max(), out_min, out_max).then(Lut::gamma(gamma));
+    Mat result;
+    adjust.then(Lut::equalization(adjust.map(histogram))).apply(img, result);
+    return result;
+}
 
-    vector cpdf(256, 0.0);
-    cpdf[0] = pdf[0];
-    for (int i = 1; i < 256; i++) {
-        cpdf[i] = cpdf[i-1] + pdf[i];
-    }
 
-    vector<uchar> lut(256, 0);
-    for (int i = 0; i < 256; i++) {
-        lut[i] = saturate_cast<uchar>(255.0 * cpdf[i]);
+// The level that counts as white: 255 or 65535 for integer images, 1 for
+// float.
+double fullScale(const Mat& img) {
+    switch (img.depth()) {
+        case CV_16U:
+            return 65535.0;
+        case CV_32F:
+            return 1.0;
+        default:
+            return 255.0;
     }
+}
 
-    for (int i = 0; i < img.rows; i++) {
-        for (int j = 0; j < img.cols; j++) {
-            result.at<uchar>(i, j) = lut[img.at<uchar>(i, j)];
-        }
+// An 8-bit copy of img for the operations that only handle CV_8UC1.
+Mat to8Bit(const Mat& img) {
+    if (img.depth() == CV_8U) {
+        return img;
     }
-
+    Mat result;
+    img.convertTo(result, CV_8U, 255.0 / fullScale(img));
     return result;
 }
 
 
 int main() {
-    const Mat img = imread("../images/Hawkes_Bay_NZ.bmp", IMREAD_GRAYSCALE);
+    // Keep 16-bit and float sources at their own depth; the templated point
+    // operations handle them directly.
+    const Mat img = imread("../images/Hawkes_Bay_NZ.bmp", IMREAD_ANYDEPTH | IMREAD_GRAYSCALE);
     if (img.empty()) {
         cout << "Could not open or find the image.\n";
         return -1;
     }
+    const Mat img8 = to8Bit(img);
+    const double scale = fullScale(img);
 
     imshow("Original Image", img);
 
-    int outMin, outMax;
+    double outMin, outMax;
     double gamma;
 
-    cout << "Enter min output value for stretching/shrinking (0-255): ";
+    cout << "Enter min output value for stretching/shrinking (0-" << scale << "): ";
     cin >> outMin;
-    cout << "Enter max output value for stretching/shrinking (0-255): ";
+    cout << "Enter max output value for stretching/shrinking (0-" << scale << "): ";
     cin >> outMax;
 
     const Mat stretched = histogramStretchShrink(img, outMin, outMax);
@@ -226,6 +175,12 @@ int main() {
     const Mat equalized = histogramEqualization(img);
     imshow("Equalized Image", equalized);
 
+    const Mat adaptive = adaptiveEqualization(img8);
+    imshow("Adaptively Equalized Image", adaptive);
+
+    const Mat combined = stretchGammaEqualize(img8, outMin * 255.0 / scale, outMax * 255.0 / scale, gamma);
+    imshow("Stretched, Gamma Corrected and Equalized Image", combined);
+
     while (waitKey(0) & 0xFF != 27){}
     return 0;
-}
\ No newline at end of file
+}